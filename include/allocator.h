@@ -0,0 +1,36 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+
+// A table of functions memory is taken from and given back to, with a pointer that is passed to all of them. It can be
+// attached to a root Vec, an Arr or CPI so a workload can bring its own arena, pool or huge page allocator. Sizes are
+// always passed back exactly as they were allocated with, so the allocator does not need to store them.
+// Every function has to be safe to call from any thread and, like alloc, exit instead of returning NULL.
+typedef struct Allocator {
+	void* 	(*p_alloc)(void* p_user, size_t size, size_t alignment);
+	void* 	(*p_realloc)(void* p_user, void* ptr, size_t old_size, size_t size, size_t alignment);
+	void 	(*p_free)(void* p_user, void* ptr, size_t size);
+	void* 	p_user;
+} Allocator;
+
+// alloc, alloc_Aligned and free, the behavior when no allocator is given
+extern const Allocator allocator_default;
+
+// p_allocator may be NULL for allocator_default
+void* 	allocator_Alloc(
+			const Allocator* p_allocator,
+			size_t size,
+			size_t alignment);
+void* 	allocator_Realloc(
+			const Allocator* p_allocator,
+			void* ptr,
+			size_t old_size,
+			size_t size,
+			size_t alignment);
+void 	allocator_Free(
+			const Allocator* p_allocator,
+			void* ptr,
+			size_t size);
+
+#endif // ALLOCATOR_H
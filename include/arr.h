@@ -1,18 +1,26 @@
 #ifndef ARR_H
 #define ARR_H
 
+#include <stddef.h>
+#include <stdbool.h>
+#include "allocator.h"
+
 typedef struct Arr {
 	unsigned char* 	p_data;
 	size_t  		count;
 	size_t  		capacity;
+	// NULL for allocator_default
+	const Allocator* p_allocator;
 } Arr;
 
 void arr_Initialize(Arr* p_arr);
+void arr_InitializeWithAllocator(Arr* p_arr, const Allocator* p_allocator);
 Arr arr_Create();
+void arr_Destroy(Arr* p_arr);
 unsigned char* arr_At(Arr arr);
 size_t arr_GetCount(Arr arr);
 size_t arr_GetCapacity(Arr arr);
 void arr_SetCount(Arr* p_arr, size_t new_count);
 bool arr_SetCapacity(Arr* p_arr, size_t new_capacity);
 
-#endif // ARR_H
\ No newline at end of file
+#endif // ARR_H
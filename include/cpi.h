@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdarg.h>
 #include <shaderc/shaderc.h>
+#include "allocator.h"
 
 typedef struct {
     struct { float x, y, w, h; } 	rect;
@@ -18,6 +19,9 @@ typedef struct {
 // main
 // ======================================================================================================================
 void 					cpi_Initialize();
+// all memory of cpi, including its Vecs, comes from p_allocator, which has to outlive it. NULL keeps the default
+void 					cpi_InitializeWithAllocator(
+							const Allocator* p_allocator);
 void 					cpi_Debug();
 
 // ======================================================================================================================
@@ -28,6 +32,9 @@ void    				cpi_GPUDevice_Destructor(
 							void* p_gpu_device);
 void    				cpi_GPUDevice_Destroy(
 							int* p_gpu_device_index);
+// once frozen no gpu device can be created or destroyed until thawed, but reading them takes no locks
+void 					cpi_GPUDevice_Freeze();
+void 					cpi_GPUDevice_Thaw();
 
 // ======================================================================================================================
 // Windows
@@ -58,6 +65,9 @@ void 					cpi_Shader_Destructor(
 							void* p_shader);
 void 					cpi_Shader_Destroy(
 							int* p_shader_index);
+// once frozen no shader can be created or destroyed until thawed, but reading them takes no locks
+void 					cpi_Shader_Freeze();
+void 					cpi_Shader_Thaw();
 
 // ======================================================================================================================
 // Graphics Pipeline
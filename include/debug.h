@@ -12,6 +12,7 @@
 void debug_Printf(const char* message, size_t line, const char* file);
 void* debug_Malloc(size_t size, size_t line, const char* file);
 void* debug_Realloc(void* ptr, size_t size, size_t line, char* file);
+void* debug_AlignedAlloc(size_t alignment, size_t size, size_t line, const char* file);
 void debug_Free(void* ptr, size_t line, const char* file);
 void debug_StartScope(size_t line, const char* file);
 void debug_EndScope();
@@ -23,6 +24,7 @@ void debug_PrintMemory();
 
 #define malloc(size)       debug_Malloc (size, __LINE__, __FILENAME__)
 #define realloc(ptr, size) debug_Realloc(ptr, size, __LINE__, __FILENAME__)
+#define aligned_alloc(alignment, size) debug_AlignedAlloc(alignment, size, __LINE__, __FILENAME__)
 #define free(ptr)          debug_Free   (ptr, __LINE__, __FILENAME__)
 #define printf(fmt, ...)   do {char buffer[2048]; snprintf(buffer, sizeof(buffer), fmt, ##__VA_ARGS__); debug_Printf(buffer, __LINE__, __FILENAME__); } while (0)
 
@@ -77,5 +79,6 @@ void debug_PrintMemory();
 #endif
 
 void* alloc(void* ptr, size_t size);
+void* alloc_Aligned(void* ptr, size_t old_size, size_t size, size_t alignment);
 
 #endif // CPI_DEBUG_H
\ No newline at end of file
@@ -7,11 +7,20 @@ typedef unsigned short Type;
 typedef const char*    Type_Name;
 typedef unsigned short Type_Size;
 typedef void (*Type_Destructor)(void* type_instance);
+// a part of a Type that can be stored on its own, see vec_SetColumnar_UnsafeWrite
+typedef struct Type_Field {
+	Type_Name   		name;
+	Type_Size 			offset;
+	Type_Size 			size;
+} Type_Field;
 typedef struct Type_Info {
 	Type 				type;
 	Type_Name   		name;
 	Type_Size 			size;
 	Type_Destructor 	destructor;
+	// NULL until type_SetFields_Safe
+	const Type_Field* 	p_fields;
+	unsigned int 		fields_count;
 } Type_Info;
 
 extern Type 			null_type;
@@ -32,5 +41,20 @@ Type_Size 		type_GetSize_Safe(
 					Type type);
 Type_Destructor type_GetDestructor_Safe(
 					Type type);
+// p_fields is not copied and has to outlive the type. fields may leave out padding but cannot overlap. a type has its
+// fields set once, returns false if they were set already
+// static const Type_Field rect_fields[] = {
+//     {"x", offsetof(Rect, rect.x), sizeof(float)},
+//     {"y", offsetof(Rect, rect.y), sizeof(float)},
+//     {"color", offsetof(Rect, color), sizeof(((Rect*)0)->color)},
+//     ...
+// };
+bool 			type_SetFields_Safe(
+					Type type,
+					const Type_Field* p_fields,
+					unsigned int fields_count);
+const Type_Field* type_GetFields_Safe(
+					Type type,
+					unsigned int* p_fields_count);
 
 #endif // VEC_TYPE_H
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define CPI_ARRAY_H
 
 #include "type.h"
+#include "allocator.h"
 #include <stdbool.h>
 #include <stdarg.h>
 #include <SDL3/SDL.h>
@@ -11,30 +12,162 @@
 // Whenever you have a Vec* this class assumes that all parent Vecs are read locked
 // ================================================================================================================================
 
-// 64 bytes
+typedef enum Vec_TransactionMode {
+	VEC_TRANSACTION_READ = 0,
+	VEC_TRANSACTION_WRITE
+} Vec_TransactionMode;
+
+typedef enum Vec_LockGranularity {
+	VEC_LOCK_GRANULARITY_PER_NODE = 0,
+	VEC_LOCK_GRANULARITY_COARSE
+} Vec_LockGranularity;
+
+typedef enum Vec_LockPolicy {
+	VEC_LOCK_POLICY_READ_PREFERRING = 0,
+	VEC_LOCK_POLICY_WRITE_PREFERRING,
+	VEC_LOCK_POLICY_FAIR
+} Vec_LockPolicy;
+
+#define VEC_CACHE_LINE_SIZE 64
+
+#define VEC_FLAG_FROZEN 	0x01
+#define VEC_FLAG_COARSE 	0x02
+#define VEC_FLAG_COVERED 	0x04
+#define VEC_FLAG_REPLICATED 0x08
+#define VEC_FLAG_MAPPED 	0x10
+#define VEC_FLAG_STABLE 	0x20
+#define VEC_FLAG_ARENA_ROOT 0x40
+#define VEC_FLAG_COLUMNAR 	0x80
+
+// storage of at least this many bytes is mapped from the system instead of the heap
+#define VEC_MAP_THRESHOLD 	(2 * 1024 * 1024)
+
+// map_flags of vec_SetMapFlags_UnsafeWrite. they only affect storage that is mapped, see VEC_MAP_THRESHOLD
+// back the storage with transparent huge pages where the system has them
+#define VEC_MAP_HUGE_PAGES 	0x01
+// fault in storage when it is mapped or grown, so the first writes to new elements do not take page faults
+#define VEC_MAP_PREFAULT 	0x02
+// transparent huge page size on x86-64 and on arm64 with 4K pages. huge mapped storage starts on one
+#define VEC_HUGE_PAGE_SIZE 	(2 * 1024 * 1024)
+
+typedef struct Vec_TypeIndices Vec_TypeIndices;
+typedef struct Vec_Arena Vec_Arena;
+
+// one reader count of a replicated Vec. every count has a cache line of its own so readers counted in different slots
+// never write to the same line
+typedef struct Vec_ReaderSlot {
+	SDL_AtomicInt 		readers __attribute__((aligned(VEC_CACHE_LINE_SIZE)));
+} Vec_ReaderSlot;
+
+// 128 bytes, aligned to a cache line
+// Sibling Vecs are stored back to back in their parent's p_data, so the words written by every lock get a cache line
+// of their own. Otherwise locking one Vec would evict the read mostly fields of itself and its neighbour from every
+// other core. sequence lives with the read mostly fields since it only changes when a writer changes them as well.
 typedef struct Vec Vec;
 struct Vec {
-	SDL_Mutex*  		p_internal_lock;
-	SDL_RWLock* 		p_rw_lock;
-	SDL_Mutex* 			p_read_lock;
+	// written by every lock and unlock
+	SDL_AtomicInt 		lock __attribute__((aligned(VEC_CACHE_LINE_SIZE)));
+	SDL_AtomicInt 		ticket;
+	// bumped on this Vec and all its ancestors whenever a Vec below it is added, removed or moved, see Vec_PathCache
+	SDL_AtomicInt 		generation;
+	// only read by writers growing the Vec, who own this line anyway. 0 for both is the default, see vec_SetGrowthPolicy
+	unsigned short 		growth_percent;
+	// VEC_MAP_* flags for mapped storage, see vec_SetMapFlags_UnsafeWrite
+	unsigned char 		map_flags;
+	unsigned int 		growth_chunk;
+	// unique for every initialized Vec, so a Vec is never mistaken for an earlier one that lived at the same address.
+	// only compared by path caches, which lock this Vec anyway
+	unsigned int 		id;
+	// shared by every Vec of a tree made with vec_InitializeWithArena, NULL otherwise
+	Vec_Arena* 			p_arena;
+	// shared by every Vec of a tree made with vec_InitializeWithAllocator, NULL for the slabs and alloc
+	const Allocator* 	p_allocator;
+	// only used by writers destroying and reusing elements. the indices of destroyed elements that are handed out again
+	// before the Vec grows, the stack only grows when more elements are destroyed than it has room for
+	size_t* 			p_free_indices;
+	size_t  			free_capacity;
+	size_t  			free_count;
+
+	// only written while write locked
+	SDL_AtomicInt 		sequence __attribute__((aligned(VEC_CACHE_LINE_SIZE)));
+	Type				type;
+	unsigned char 		lock_policy;
+	unsigned char 		flags;
 	Vec*   				p_parent;
 	unsigned char* 		p_data;
-	unsigned char  		reading_count;
-	unsigned char  		writing_locks;
-	Type				type;
-	unsigned int  		count;
-	unsigned int  		capacity;
-}; 
-
+	size_t  			count;
+	size_t  			capacity;
+	Vec_ReaderSlot* 	p_reader_slots;
+	// one bit per element that is set while the element is live. NULL until the first element is destroyed, see
+	// vec_DestroyElement_UnsafeWrite
+	Uint64* 			p_occupancy;
+	// index of the first child Vec of every Type, only kept for Vecs of vec_type
+	Vec_TypeIndices* 	p_type_indices;
+};
 extern Type vec_type;
 
+typedef struct Vec_Transaction Vec_Transaction;
+typedef struct Vec_Snapshot Vec_Snapshot;
+typedef struct Vec_Path Vec_Path;
+
+#define VEC_CURSOR_MAX_DEPTH 16
+
+// a MoveTo position that lives on the caller's stack, so moving around a hierarchy never allocates.
+// p_vec comes first so the Vec** handed out by vec_MoveStart is the cursor itself. p_stack holds the Vecs moved through
+// to get here, deeper than VEC_CURSOR_MAX_DEPTH they are found through p_parent instead
+typedef struct Vec_Cursor {
+	Vec* 				p_vec;
+	unsigned int 		depth;
+	Vec* 				p_stack[VEC_CURSOR_MAX_DEPTH];
+} Vec_Cursor;
+
+#define VEC_PATH_CACHE_SIZE 16
+
+// the Vecs a Vec_Path led to from p_vec, valid for as long as the generation of p_vec has not changed
+typedef struct Vec_PathCacheEntry {
+	Vec* 				p_vec;
+	unsigned int 		vec_id;
+	unsigned int 		path_id;
+	unsigned int 		indices_count;
+	int 				generation;
+	Vec* 				p_vecs[VEC_CURSOR_MAX_DEPTH];
+} Vec_PathCacheEntry;
+
+// remembers where compiled paths led so moving along them again locks the same Vecs without walking the hierarchy.
+// it is not locked so every thread needs its own, zero initialized
+typedef struct Vec_PathCache {
+	Vec_PathCacheEntry 	p_entries[VEC_PATH_CACHE_SIZE];
+} Vec_PathCache;
+
 // ================================================================================================================================
 // Fundamental 
 // ================================================================================================================================
+// Vecs inherit the arena and allocator of their parent.
 void 				vec_Initialize(
 						Vec* p_vec, 
 						Vec* p_parent, 
 						Type type);
+// p_vec becomes the root of a tree whose storage all comes from one arena, see vec_arena.h. chunk_size 0 takes
+// VEC_ARENA_CHUNK_SIZE. Destroying the root gives back the arena at once instead of freeing the Vecs below it one by
+// one. Element destructors still run: the Vecs holding child Vecs are walked to find the ones whose type has a
+// destructor, and nothing is freed on the way.
+// Meant for trees that are built and torn down as a unit.
+void 				vec_InitializeWithArena(
+						Vec* p_vec,
+						Vec* p_parent,
+						Type type,
+						size_t chunk_size);
+// all storage of p_vec and the Vecs below it comes from p_allocator, which has to outlive them. NULL keeps the default.
+// storage of these Vecs is never mapped by the Vec itself, that is up to the allocator
+void 				vec_InitializeWithAllocator(
+						Vec* p_vec,
+						Vec* p_parent,
+						Type type,
+						const Allocator* p_allocator);
+// where storage owned by the elements of p_vec should come from so it lives and dies with the tree: the arena of an
+// arena tree, the allocator given to vec_InitializeWithAllocator, or NULL for the slabs and the heap
+const Allocator* 	vec_GetAllocator(
+						Vec* p_vec);
 Vec 				vec_Create(
 						Vec* p_parent,
 						Type type);
@@ -62,7 +195,15 @@ bool 				vec_MatchElement_SafeRead(
 
 // ================================================================================================================================
 // Custom concurrency
+//
+// Every Vec starts out reader preferring. Write preferring and fair Vecs make new readers wait behind waiting writers,
+// so a thread that already holds a read lock on such a Vec must not read lock it again.
 // ================================================================================================================================
+void 				vec_SetLockPolicy(
+						Vec* p_vec,
+						Vec_LockPolicy lock_policy);
+Vec_LockPolicy 		vec_GetLockPolicy(
+						Vec* p_vec);
 void    			vec_LockRead(
 						Vec* p_vec);
 void    			vec_LockWrite(
@@ -80,6 +221,90 @@ unsigned short   	vec_GetReadingLocksCount(
 bool   				vec_IsWriteLocked(
 						Vec* p_vec);
 
+// ================================================================================================================================
+// Upgradable reading
+//
+// One thread at a time can hold a Vec upgradable read locked. It reads alongside plain readers, and unlike
+// vec_SwitchReadToWrite, vec_UpgradeToWrite never lets go of the Vec, so whatever was read is still true once writing.
+// ================================================================================================================================
+void 				vec_LockUpgradableRead(
+						Vec* p_vec);
+void 				vec_UnlockUpgradableRead(
+						Vec* p_vec);
+void 				vec_UpgradeToWrite(
+						Vec* p_vec);
+void 				vec_DowngradeWriteToUpgradable(
+						Vec* p_vec);
+void 				vec_DowngradeUpgradableToRead(
+						Vec* p_vec);
+bool 				vec_IsUpgradableReadLocked(
+						Vec* p_vec);
+
+// ================================================================================================================================
+// Freezing
+//
+// A frozen Vec and everything below it can no longer be written, so locking it for reading or moving through it costs
+// nothing. vec_Freeze must not be called by a thread that holds the Vec itself. vec_Thaw does not wait for readers, since
+// they are not counted while frozen, so it may only be called once no other thread reads the subtree anymore.
+// ================================================================================================================================
+void 				vec_Freeze(
+						Vec* p_vec);
+void 				vec_Thaw(
+						Vec* p_vec);
+bool 				vec_IsFrozen(
+						Vec* p_vec);
+
+// ================================================================================================================================
+// Lock granularity
+//
+// By default every Vec has a lock of its own, so moving to a depth of five takes five nested lock and unlock pairs.
+// A Vec set to VEC_LOCK_GRANULARITY_COARSE becomes a coarse root whose lock alone guards everything below it. Its
+// descendants are covered: locking them for reading costs nothing since whoever reaches them already holds the coarse
+// root, and writing them requires the coarse root to be write locked. Covered Vecs also share the sequence of their
+// coarse root. Small trees that are traversed often pay one lock instead of one per level, large shared trees keep
+// per node locking. The granularity can only be changed while the Vec is write locked, and a covered Vec cannot
+// change it at all.
+// ================================================================================================================================
+void 				vec_SetLockGranularity(
+						Vec* p_vec,
+						Vec_LockGranularity lock_granularity);
+Vec_LockGranularity vec_GetLockGranularity(
+						Vec* p_vec);
+
+// ================================================================================================================================
+// Replicated reading
+//
+// Every reader of a Vec increments the same lock word, so on many cores a hot Vec that is almost only read spends its
+// time moving that cache line between cores. A replicated Vec counts its readers in as many slots as there are cores
+// instead. Slots are handed to threads round robin the first time they read and kept for good, since a read lock has to
+// be released in the slot it was taken in. As long as no more threads read than there are cores, no two readers write
+// to the same cache line, beyond that threads share slots. Writers pay for it: they announce themselves in the lock
+// word and then wait for every slot to drain. Readers of a replicated Vec ignore the lock policy and always let an
+// announced writer go first. Replication can only be switched while the Vec is write locked.
+// Read locks of a replicated Vec are not reentrant: a thread that already read locks it must not read lock it again,
+// also not through a _SafeRead function. A writer that announced itself in between waits for the outer read lock
+// while the inner one keeps backing off to the writer, so neither ever gets through.
+// ================================================================================================================================
+void 				vec_SetReplicatedReading(
+						Vec* p_vec,
+						bool replicated);
+bool 				vec_IsReplicatedReading(
+						Vec* p_vec);
+
+// ================================================================================================================================
+// Copying elements
+//
+// Copies element index of the child of p_vec with the given type into p_dst under a read lock of that child. Elements
+// are copied out instead of pointed at, since a writer can free p_data as soon as the read lock is released.
+// Every write lock makes p_vec->sequence odd and every write unlock makes it even again, snapshots use it to tell
+// whether a Vec changed since they were taken.
+// ================================================================================================================================
+bool 				vec_CopyElementFromVecWithType_SafeRead(
+						Vec* p_vec,
+						Type type,
+						int index,
+						void* p_dst);
+
 // ================================================================================================================================
 // IsValid
 // ================================================================================================================================
@@ -96,6 +321,10 @@ bool 				vec_IsValidAtPath_SafeRead(
 						Vec* p_vec,  
 						Type type, 
 						const char* path);
+bool 				vec_IsValidAtCompiledPath_SafeRead(
+						Vec* p_vec,
+						Type type,
+						const Vec_Path* p_path);
 
 // ================================================================================================================================
 // MoveTo
@@ -104,9 +333,16 @@ bool 				vec_IsValidAtPath_SafeRead(
 // When moving forward (parent to child), each intermediate Vec is locked, but the final Vec remains unlocked, letting you decide its lock state.
 // When moving backward (child to parent), they unlock the parent Vecs as you go, so by the time you return to the starting Vec, all locks are released.
 // For simplicity and safety, use only one Vec pointer per thread to avoid complex lock management.
+// The …Upgradable variants upgradable read lock the Vec they arrive at instead. It has to be back to read locked before moving on or ending.
+// vec_MoveStart takes a Vec_Cursor that has to outlive the Vec** it returns, typically a local next to it. Only Vec** from
+// vec_MoveStart can be passed to the other MoveTo functions.
 // This also enforce index sequence rules: a positive index moves to a child, a negative index to a parent, and a positive index cannot immediately precede a negative one. 
 // ================================================================================================================================
 Vec** 				vec_MoveStart(
+						Vec_Cursor* p_cursor,
+						Vec* p_vec);
+Vec** 				vec_MoveStartUpgradable(
+						Vec_Cursor* p_cursor,
 						Vec* p_vec);
 void 				vec_MoveEnd(
 						Vec** pp_vec);
@@ -114,6 +350,10 @@ void 				vec_MoveToIndex(
 						Vec** pp_vec,
 						int index,
 						Type type);
+void 				vec_MoveToIndexUpgradable(
+						Vec** pp_vec,
+						int index,
+						Type type);
 void 				vec_MoveToIndices(
 						Vec** pp_vec,
 						size_t indices_count, 
@@ -129,8 +369,85 @@ void* 				vec_MoveToPathAndGetElement(
 						Vec** pp_vec,
 						const char* path, 
 						Type type);
+// p_cache can be NULL. paths that go to a parent are never cached
+void 				vec_MoveToCompiledPath(
+						Vec** pp_vec,
+						const Vec_Path* p_path,
+						Vec_PathCache* p_cache);
+void* 				vec_MoveToCompiledPathAndGetElement(
+						Vec** pp_vec,
+						const Vec_Path* p_path,
+						Type type,
+						Vec_PathCache* p_cache);
 
 
+// ================================================================================================================================
+// Transactions
+//
+// A transaction locks several Vecs below one root at once, each given by its path of child indices from the root and
+// whether it is read or written. vec_Transaction_Lock takes every lock in a single pass: each Vec on the way is locked
+// once no matter how many paths go through it, and all Vecs are locked in the same order (parents before children,
+// lower indices before higher), so two transactions or a transaction and a MoveTo cursor can never wait on each other
+// in a circle. Vecs below a written Vec are covered by its write lock and are not locked on their own, but written ones
+// still get their sequence bumped, so snapshots see the change. Everything is released together by
+// vec_Transaction_Unlock, so whatever is done in between is atomic across all the Vecs.
+// Paths can only go down, so -1 is not allowed, and an empty path is the root itself.
+// vec_Transaction_AddVecWithType adds the child of the root with the given type instead of a path. Its index is looked
+// up by vec_Transaction_Lock after the root is locked, so it cannot go stale in between, and vec_Transaction_GetVec
+// gives NULL for it if the root has no child of that type.
+// ================================================================================================================================
+Vec_Transaction* 	vec_Transaction_Create(
+						Vec* p_root);
+void 				vec_Transaction_Destroy(
+						Vec_Transaction* p_transaction);
+int 				vec_Transaction_AddIndices(
+						Vec_Transaction* p_transaction,
+						Vec_TransactionMode mode,
+						size_t indices_count,
+						const int* p_indices);
+int 				vec_Transaction_AddVaArgs(
+						Vec_Transaction* p_transaction,
+						Vec_TransactionMode mode,
+						size_t n_args,
+						...);
+int 				vec_Transaction_AddPath(
+						Vec_Transaction* p_transaction,
+						Vec_TransactionMode mode,
+						const char* path);
+int 				vec_Transaction_AddVecWithType(
+						Vec_Transaction* p_transaction,
+						Vec_TransactionMode mode,
+						Type type);
+void 				vec_Transaction_Lock(
+						Vec_Transaction* p_transaction);
+void 				vec_Transaction_Unlock(
+						Vec_Transaction* p_transaction);
+Vec* 				vec_Transaction_GetVec(
+						Vec_Transaction* p_transaction,
+						int entry);
+
+// ================================================================================================================================
+// Snapshots
+//
+// vec_Snapshot copies a whole subtree while holding it read locked, so it is a consistent view of one moment. The copy
+// is frozen, so it can be read by any thread without locks while writers keep changing the live tree. Given the
+// previous snapshot of the same Vec, only the leaves whose sequence changed since then are copied again, every other
+// leaf shares its data with the previous snapshot. Snapshotting a leaf that did not change since p_previous returns
+// p_previous itself, retained, with the same version. Snapshots are reference counted and freed by the last release.
+// Elements are copied byte by byte without running any type functions, so pointers in them refer to the live objects.
+// ================================================================================================================================
+Vec_Snapshot* 		vec_Snapshot(
+						Vec* p_vec,
+						Vec_Snapshot* p_previous);
+void 				vec_Snapshot_Retain(
+						Vec_Snapshot* p_snapshot);
+void 				vec_Snapshot_Release(
+						Vec_Snapshot* p_snapshot);
+Vec* 				vec_Snapshot_GetVec(
+						Vec_Snapshot* p_snapshot);
+unsigned int 		vec_Snapshot_GetVersion(
+						Vec_Snapshot* p_snapshot);
+
 // ================================================================================================================================
 // UpsertVecWithType…_SafeWrite
 // ================================================================================================================================
@@ -141,13 +458,72 @@ int 				vec_UpsertVecWithTypeFromIndex_UnsafeWrite(
 						Vec* p_vec, 
 						Type type, 
 						int index);
+int 				vec_UpsertVecWithType_UpgradableRead(
+						Vec* p_vec,
+						Type type);
+int 				vec_AppendVecWithType_UnsafeWrite(
+						Vec* p_vec,
+						Type type);
 
 // ================================================================================================================================
 // UpsertNullElement_SafeWrite
+//
+// Elements destroyed with vec_DestroyElement_UnsafeWrite are zeroed and their indices kept on a stack, so
+// vec_UpsertNullElement_UnsafeWrite hands out the most recently destroyed index, or appends when there is none, without
+// looking at the elements. vec_FindNullElement_UnsafeRead returns the index the next upsert would reuse or -1. Elements
+// zeroed by hand are not found again.
 // ================================================================================================================================
 int  				vec_UpsertNullElement_UnsafeWrite(
 						Vec* p_vec,
 						Type type);
+int 				vec_FindNullElement_UnsafeRead(
+						Vec* p_vec,
+						Type type);
+int 				vec_AppendNullElement_UnsafeWrite(
+						Vec* p_vec,
+						Type type);
+// calls the destructor of the type, zeroes the element and keeps its index for reuse
+void 				vec_DestroyElement_UnsafeWrite(
+						Vec* p_vec,
+						int index,
+						Type type);
+
+// ================================================================================================================================
+// Live elements
+//
+// Every element below count is live until it is destroyed with vec_DestroyElement_UnsafeWrite. The destroyed ones are
+// tracked in a bitmap, so counting and iterating live elements looks at 64 elements per step and sparse Vecs are iterated
+// in time proportional to the live elements:
+// for (int i = vec_GetNextLiveIndex_UnsafeRead(p_vec, 0); i != -1; i = vec_GetNextLiveIndex_UnsafeRead(p_vec, i + 1))
+// ================================================================================================================================
+bool 				vec_IsElementNull_UnsafeRead(
+						Vec* p_vec,
+						int index);
+size_t 				vec_GetLiveCount_UnsafeRead(
+						Vec* p_vec);
+// returns the first live index from index and up or -1
+int 				vec_GetNextLiveIndex_UnsafeRead(
+						Vec* p_vec,
+						int index);
+
+// ================================================================================================================================
+// Compaction
+//
+// Destroyed elements are only handed out again by vec_UpsertNullElement, so a Vec that mostly lost its elements is still
+// iterated, snapshotted and stored at its old size. vec_Compact moves the live elements together in their order, drops
+// the destroyed ones and shrinks the capacity to the new count. Every live element that moved is reported to p_remap with
+// its old and new index in ascending order, so handle tables and cached indices can be fixed up in the same pass. p_remap
+// can be NULL. Moved child Vecs keep the p_parent of their own children pointing at them. Stable Vecs cannot be compacted.
+// ================================================================================================================================
+typedef void (*Vec_Remap)(void* p_user, size_t old_index, size_t new_index);
+void 				vec_Compact_SafeWrite(
+						Vec* p_vec,
+						Vec_Remap p_remap,
+						void* p_user);
+void 				vec_Compact_UnsafeWrite(
+						Vec* p_vec,
+						Vec_Remap p_remap,
+						void* p_user);
 
 // ================================================================================================================================
 // Create Locking
@@ -160,6 +536,9 @@ void				vec_CreateAtVaArgs_UnsafeWrite(
         
 // ================================================================================================================================
 // GetIndexVecWithType…_SafeRead
+//
+// Every Vec of vec_type keeps the index of its first child of every Type, so finding it takes constant time and does not
+// lock the children.
 // ================================================================================================================================
 int 				vec_GetVecWithType_UnsafeRead(
 						Vec* p_vec, 
@@ -184,15 +563,15 @@ char*				vec_GetPathBetween_SafeRead(
 // ================================================================================================================================
 unsigned char* 		vec_GetElement_UnsafeRead(
 						Vec* p_vec,
-						int index,
+						size_t index,
 						Type type);
 unsigned int 		vec_GetElementSize_UnsafeRead(
 						Vec* p_vec);
 Type 				vec_GetType_UnsafeRead(
 						Vec* p_vec);
-unsigned int		vec_GetCount_UnsafeRead(
+size_t				vec_GetCount_UnsafeRead(
 						Vec* p_vec);
-unsigned int		vec_GetCapacity_UnsafeRead(
+size_t				vec_GetCapacity_UnsafeRead(
 						Vec* p_vec);
 
 // ================================================================================================================================
@@ -200,10 +579,135 @@ unsigned int		vec_GetCapacity_UnsafeRead(
 // ================================================================================================================================
 void  				vec_SetCount_UnsafeWrite(
 						Vec* p_vec, 
-						unsigned int count);
+						size_t count);
 void  				vec_SetCapacity_UnsafeWrite(
 						Vec* p_vec, 
-						unsigned int capacity);
+						size_t capacity);
+
+// ================================================================================================================================
+// Growth
+//
+// A Vec grows to the next power of two above its count by default. With a growth policy it grows to growth_percent of
+// its capacity instead, and by at least min_chunk elements. Storage of VEC_MAP_THRESHOLD bytes or more is mapped from the
+// system on Linux, so growing it remaps pages instead of copying them and capacity that is never written costs nothing.
+// Counts, capacities and byte offsets are size_t, so a Vec can hold more than 4G elements.
+// vec_SetCountUninitialized_UnsafeWrite does not zero the new elements, for callers that overwrite them right away.
+// vec_SetMapFlags_UnsafeWrite trades that laziness for speed on mapped storage: VEC_MAP_HUGE_PAGES asks for transparent
+// huge pages so a large Vec needs a fraction of the TLB entries, and VEC_MAP_PREFAULT faults in capacity as it is mapped
+// so streaming writes into it never stop for a page fault. Both are ignored for storage that is not mapped.
+// ================================================================================================================================
+void 				vec_SetGrowthPolicy_UnsafeWrite(
+						Vec* p_vec,
+						unsigned int growth_percent,
+						unsigned int min_chunk);
+void 				vec_SetMapFlags_UnsafeWrite(
+						Vec* p_vec,
+						unsigned int map_flags);
+void 				vec_Reserve_UnsafeWrite(
+						Vec* p_vec,
+						size_t capacity);
+void 				vec_ShrinkToFit_UnsafeWrite(
+						Vec* p_vec);
+void 				vec_SetCountUninitialized_UnsafeWrite(
+						Vec* p_vec,
+						size_t count);
+
+// ================================================================================================================================
+// Stable addresses
+//
+// A stable Vec reserves address space for max_capacity elements up front and never moves an element once it exists, so
+// pointers to its elements and child Vecs can be kept across calls. Pages are only backed by memory once they are
+// written, so a generous max_capacity costs address space and nothing else. It cannot grow past max_capacity, and
+// elements can only be inserted or removed at the end. vec_ShrinkToFit_UnsafeWrite hands the pages past count back to
+// the system instead of moving anything.
+// ================================================================================================================================
+void 				vec_SetStableAddresses_UnsafeWrite(
+						Vec* p_vec,
+						size_t max_capacity);
+bool 				vec_HasStableAddresses(
+						Vec* p_vec);
+
+// ================================================================================================================================
+// Columns
+//
+// A columnar Vec stores every field its Type registered with type_SetFields_Safe in a column of its own: all x, then
+// all y, then all colors. A pass that touches two fields of every element reads only those two columns, and
+// consecutive values of one field are next to each other for SIMD. Every column starts on a cache line. Columns move
+// whenever the Vec grows, so a column pointer is only valid until the next write.
+// Elements are not stored as a whole anywhere. They are copied out of and into the columns, and vec_GetElement with
+// everything built on it, the bulk functions, snapshots and stable addresses cannot be used with a columnar Vec. Its
+// Type cannot have a destructor.
+// float* p_x = vec_GetColumn_UnsafeRead(p_vec, 0);
+// float* p_dx = vec_GetColumn_UnsafeRead(p_vec, 4);
+// for (size_t i = 0; i < count; ++i) {
+//     p_x[i] += p_dx[i];
+// }
+// ================================================================================================================================
+// only while the Vec is empty
+void 				vec_SetColumnar_UnsafeWrite(
+						Vec* p_vec);
+bool 				vec_IsColumnar(
+						Vec* p_vec);
+void* 				vec_GetColumn_UnsafeRead(
+						Vec* p_vec,
+						unsigned int field_index);
+void 				vec_CopyElementFromColumns_UnsafeRead(
+						Vec* p_vec,
+						size_t index,
+						void* p_element);
+void 				vec_CopyElementToColumns_UnsafeWrite(
+						Vec* p_vec,
+						size_t index,
+						const void* p_element);
+
+// ================================================================================================================================
+// Bulk…_SafeWrite
+//
+// Insert, append or remove a range of elements with one lock, one memmove and at most one reallocation. Inserted
+// elements are copied from p_src_data, or zeroed when it is NULL. Removed elements are destructed.
+// Vecs of vec_type only take NULL, so new children are initialized afterwards. Children that move keep the p_parent of
+// their own children pointing at them. The …_UnsafeWrite variants expect p_vec to be write locked already.
+// vec_OverwriteFromOther copies bytes without running any type functions and cannot be used on Vecs of vec_type.
+// vec_OverwriteFromOther_SafeWrite locks the two Vecs in the order transactions use, by their index paths.
+// ================================================================================================================================
+void 				vec_InsertElements_SafeWrite(
+						Vec* p_vec,
+						size_t index,
+						size_t count,
+						const void* p_src_data);
+void 				vec_InsertElements_UnsafeWrite(
+						Vec* p_vec,
+						size_t index,
+						size_t count,
+						const void* p_src_data);
+void 				vec_AppendElements_SafeWrite(
+						Vec* p_vec,
+						size_t count,
+						const void* p_src_data);
+void 				vec_AppendElements_UnsafeWrite(
+						Vec* p_vec,
+						size_t count,
+						const void* p_src_data);
+void 				vec_RemoveElements_SafeWrite(
+						Vec* p_vec,
+						size_t index,
+						size_t count);
+void 				vec_RemoveElements_UnsafeWrite(
+						Vec* p_vec,
+						size_t index,
+						size_t count);
+void 				vec_OverwriteFromOther_SafeWrite(
+						Vec* p_vec,
+						size_t index,
+						Vec* p_other_vec,
+						size_t other_index,
+						size_t count);
+void 				vec_OverwriteFromOther_UnsafeWrite(
+						Vec* p_vec,
+						size_t index,
+						Vec* p_other_vec,
+						size_t other_index,
+						size_t count);
 
 
 #endif // CPI_LIST_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef VEC_ARENA_H
+#define VEC_ARENA_H
+
+#include "allocator.h"
+#include <stddef.h>
+
+// chunks are at least this big unless the arena is created with a size of its own
+#define VEC_ARENA_CHUNK_SIZE (64 * 1024)
+
+// hands out memory by bumping an offset through chunks and gives all of it back at once when destroyed. only the
+// latest allocation can grow, shrink or be freed in place, everything else stays until vec_Arena_Destroy.
+// allocations are guarded by a spin lock so Vecs of one tree can be written on different threads
+typedef struct Vec_Arena Vec_Arena;
+
+Vec_Arena* vec_Arena_Create(size_t chunk_size);
+void vec_Arena_Destroy(Vec_Arena* p_arena);
+// works like alloc_Aligned. ptr may be NULL, size 0 frees ptr and returns NULL
+void* vec_Arena_Alloc(Vec_Arena* p_arena, void* ptr, size_t old_size, size_t size, size_t alignment);
+void vec_Arena_Free(Vec_Arena* p_arena, void* ptr);
+size_t vec_Arena_GetSize(Vec_Arena* p_arena);
+// the arena as an Allocator, for storage that belongs to a Vec of the tree without being allocated by the Vec itself.
+// it lives as long as the arena
+const Allocator* vec_Arena_GetAllocator(Vec_Arena* p_arena);
+
+#endif // VEC_ARENA_H
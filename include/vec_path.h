@@ -9,6 +9,18 @@
 
 char* vec_Path_Combine(const char* path_1, const char* path_2);
 int* vec_Path_ToIndices(const char* path, size_t* const out_indices_count);
+size_t vec_Path_ToIndicesBuffer(const char* path, int* p_indices, size_t capacity);
 char* vec_Path_FromVaArgs(size_t n_args, ...);
 
+// a path parsed once. id is unique for every created Vec_Path so a Vec_PathCache never mistakes one for an earlier one
+// that lived at the same address
+typedef struct Vec_Path {
+    unsigned int id;
+    unsigned int indices_count;
+    int p_indices[];
+} Vec_Path;
+
+Vec_Path* vec_Path_Create(const char* path);
+void vec_Path_Destroy(Vec_Path* p_path);
+
 #endif // VEC_PATH_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef VEC_SLAB_H
+#define VEC_SLAB_H
+
+#include <stddef.h>
+
+// Buffers of a Vec are its capacity times the Type_Size of its elements. Capacities mostly grow in powers of two, so
+// the buffers of every Type fall into a few power of two classes from VEC_SLAB_MIN_SIZE up to VEC_SLAB_MAX_SIZE.
+// Every class has a pool of blocks carved from VEC_SLAB_SIZE slabs, and every thread keeps up to VEC_SLAB_CACHE_COUNT
+// free blocks per class that it allocates from and frees to without any locking. Only when a thread's cache runs empty
+// or full it takes or gives back half of it from the pool. Slabs are never given back to the system.
+// Blocks are aligned to VEC_SLAB_MIN_SIZE, so they can hold child Vecs.
+#define VEC_SLAB_MIN_SIZE 		64
+#define VEC_SLAB_MAX_SIZE 		4096
+#define VEC_SLAB_SIZE 			(64 * 1024)
+#define VEC_SLAB_CACHE_COUNT 	32
+
+// size of the blocks size is served from, 0 if it is too large for a slab
+size_t vec_Slab_GetClassSize(size_t size);
+// size has to be between 1 and VEC_SLAB_MAX_SIZE. blocks are freed with the size they were allocated with
+void* vec_Slab_Alloc(size_t size);
+void vec_Slab_Free(void* ptr, size_t size);
+
+#endif // VEC_SLAB_H
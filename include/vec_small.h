@@ -0,0 +1,59 @@
+#ifndef VEC_SMALL_H
+#define VEC_SMALL_H
+
+#include "type.h"
+#include "vec.h"
+#include <stdbool.h>
+
+// bytes of elements a Vec_Small holds before it spills to the heap
+#define VEC_SMALL_INLINE_SIZE 40
+
+// A leaf Vec without a lock of its own, for small data of a node that is only ever read and written under the lock of
+// the Vec it is stored in. Store them as the elements of a Vec of vec_small_type. Up to VEC_SMALL_INLINE_SIZE bytes of
+// elements are kept inside it, more spill to a buffer from wherever the tree of that Vec takes its storage, see
+// vec_GetAllocator, so spills of an arena tree go away with the arena. A Vec_Small never points into itself, so it can
+// be moved with the Vec it is stored in. 64 bytes against the 128 of a Vec and nothing on the heap until it spills.
+// _UnsafeRead and _UnsafeWrite mean the lock of the Vec it is stored in.
+typedef struct Vec_Small {
+	Type 				type;
+	unsigned int  		count;
+	// in elements. the elements are inline as long as they fit
+	unsigned int  		capacity;
+	// spills come from here, NULL for the slabs and alloc
+	const Allocator* 	p_allocator;
+	union {
+		unsigned char* 	p_heap;
+		unsigned char 	p_inline[VEC_SMALL_INLINE_SIZE];
+	};
+} Vec_Small;
+
+// destroys the elements and frees the spilled buffer of a Vec_Small element when its Vec is destroyed
+extern Type vec_small_type;
+
+// p_vec is the Vec p_small is stored in
+void 			vec_Small_Initialize(
+					Vec_Small* p_small,
+					Vec* p_vec,
+					Type type);
+void 			vec_Small_Destroy(
+					void* p_small);
+unsigned int 	vec_Small_GetCount_UnsafeRead(
+					Vec_Small* p_small);
+unsigned char* 	vec_Small_GetElement_UnsafeRead(
+					Vec_Small* p_small,
+					unsigned int index,
+					Type type);
+// new elements are zeroed
+void 			vec_Small_SetCount_UnsafeWrite(
+					Vec_Small* p_small,
+					unsigned int count);
+// p_element may be NULL for a zeroed element. returns its index
+unsigned int 	vec_Small_Append_UnsafeWrite(
+					Vec_Small* p_small,
+					const void* p_element);
+// destroys the element and moves the ones after it down
+void 			vec_Small_Remove_UnsafeWrite(
+					Vec_Small* p_small,
+					unsigned int index);
+
+#endif // VEC_SMALL_H
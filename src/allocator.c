@@ -0,0 +1,52 @@
+#include "allocator.h"
+#include "debug.h"
+#include <stdlib.h>
+
+// alignments up to a pointer are what malloc gives anyway
+static void* _allocator_Default_Alloc(void* p_user, size_t size, size_t alignment) {
+    if (alignment > sizeof(void*)) {
+        DEBUG_SCOPE(void* ptr = alloc_Aligned(NULL, 0, size, alignment));
+        return ptr;
+    }
+    DEBUG_SCOPE(void* ptr = alloc(NULL, size));
+    return ptr;
+}
+static void* _allocator_Default_Realloc(void* p_user, void* ptr, size_t old_size, size_t size, size_t alignment) {
+    if (alignment > sizeof(void*)) {
+        DEBUG_SCOPE(ptr = alloc_Aligned(ptr, old_size, size, alignment));
+        return ptr;
+    }
+    DEBUG_SCOPE(ptr = alloc(ptr, size));
+    return ptr;
+}
+static void _allocator_Default_Free(void* p_user, void* ptr, size_t size) {
+    DEBUG_SCOPE(free(ptr));
+}
+
+const Allocator allocator_default = {
+    .p_alloc = _allocator_Default_Alloc,
+    .p_realloc = _allocator_Default_Realloc,
+    .p_free = _allocator_Default_Free,
+    .p_user = NULL,
+};
+
+void* allocator_Alloc(const Allocator* p_allocator, size_t size, size_t alignment) {
+    p_allocator = p_allocator ? p_allocator : &allocator_default;
+    DEBUG_ASSERT(alignment && (alignment & (alignment - 1)) == 0, "alignment(%zu) has to be a power of two", alignment);
+    return p_allocator->p_alloc(p_allocator->p_user, size, alignment);
+}
+void* allocator_Realloc(const Allocator* p_allocator, void* ptr, size_t old_size, size_t size, size_t alignment) {
+    p_allocator = p_allocator ? p_allocator : &allocator_default;
+    DEBUG_ASSERT(alignment && (alignment & (alignment - 1)) == 0, "alignment(%zu) has to be a power of two", alignment);
+    if (!ptr) {
+        return p_allocator->p_alloc(p_allocator->p_user, size, alignment);
+    }
+    return p_allocator->p_realloc(p_allocator->p_user, ptr, old_size, size, alignment);
+}
+void allocator_Free(const Allocator* p_allocator, void* ptr, size_t size) {
+    p_allocator = p_allocator ? p_allocator : &allocator_default;
+    if (!ptr) {
+        return;
+    }
+    p_allocator->p_free(p_allocator->p_user, ptr, size);
+}
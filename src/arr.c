@@ -4,15 +4,23 @@
 #include "debug.h"
 
 void arr_Initialize(Arr* p_arr) {
+    arr_InitializeWithAllocator(p_arr, NULL);
+}
+void arr_InitializeWithAllocator(Arr* p_arr, const Allocator* p_allocator) {
     p_arr->p_data = NULL;
     p_arr->count = 0;
     p_arr->capacity = 0;
+    p_arr->p_allocator = p_allocator;
 }
 Arr arr_Create() {
     Arr arr;
     arr_Initialize(&arr);
     return arr;
 }
+void arr_Destroy(Arr* p_arr) {
+    DEBUG_SCOPE(allocator_Free(p_arr->p_allocator, p_arr->p_data, p_arr->capacity * sizeof(unsigned char)));
+    arr_InitializeWithAllocator(p_arr, p_arr->p_allocator);
+}
 unsigned char* arr_At(Arr arr) {
     return arr.p_data;
 }
@@ -23,20 +31,20 @@ size_t arr_GetCapacity(Arr arr) {
     return arr.capacity;
 }
 void arr_SetCount(Arr* p_arr, size_t new_count) {
+    size_t old_capacity = p_arr->capacity;
     if (p_arr->capacity == 0) {
         p_arr->capacity = 1;
     }
     while (new_count > p_arr->capacity) {
         p_arr->capacity = p_arr->capacity * 2;
     }
-    DEBUG_SCOPE(unsigned char* p_arr->p_data = (unsigned char*)alloc(p_arr->p_data, p_arr->capacity * sizeof(unsigned char)));
+    DEBUG_SCOPE(p_arr->p_data = allocator_Realloc(p_arr->p_allocator, p_arr->p_data, old_capacity * sizeof(unsigned char), p_arr->capacity * sizeof(unsigned char), 1));
     p_arr->count = new_count;
-    return true;
 }
 bool arr_SetCapacity(Arr* p_arr, size_t new_capacity) {
-    ASSERT(new_capacity < p_arr->count, "cant sett capacity that is less than count");
-    DEBUG_SCOPE(unsigned char* new_data = alloc(p_arr->p_data, new_capacity * sizeof(unsigned char)));
+    ASSERT(new_capacity >= p_arr->count, "cant sett capacity that is less than count");
+    DEBUG_SCOPE(unsigned char* new_data = allocator_Realloc(p_arr->p_allocator, p_arr->p_data, p_arr->capacity * sizeof(unsigned char), new_capacity * sizeof(unsigned char), 1));
     p_arr->p_data = new_data;
     p_arr->capacity = new_capacity;
     return true;
-}
\ No newline at end of file
+}
@@ -10,15 +10,6 @@
 #include <SDL3_shadercross/SDL_shadercross.h>
 #include "spirv_reflect.h"
 
-void* alloc(void* ptr, size_t size) {
-    void* tmp = (ptr == NULL) ? malloc(size) : realloc(ptr, size);
-    if (!tmp) {
-        printf("Memory allocation failed\n");
-        exit(-1);
-    }
-    return tmp;
-}
-
 // ===============================================================================================================
 // CPU states
 // ===============================================================================================================
@@ -208,6 +199,8 @@ static Type cpi_computer_pipeline_type;
 static Type cpi_shader_type;
 
 static Vec* g_vec = NULL;
+// NULL for allocator_default
+static const Allocator* g_allocator = NULL;
 #ifdef DEBUG
 	SDL_Mutex*  			g_unique_id_mutex = NULL;
 	unsigned long long  	g_unique_id = 0;
@@ -221,13 +214,20 @@ static Vec* g_vec = NULL;
 // main
 // ===============================================================================================================
 void cpi_Initialize() 
+{
+	DEBUG_SCOPE(cpi_InitializeWithAllocator(NULL));
+}
+void cpi_InitializeWithAllocator(
+	const Allocator* p_allocator)
 {
 	#ifdef DEBUG
 		DEBUG_ASSERT(!g_unique_id_mutex, "not NULL pointer");
 		DEBUG_SCOPE(g_unique_id_mutex = SDL_CreateMutex());
 	#endif
-	DEBUG_SCOPE(g_vec = alloc(NULL, sizeof(Vec)));
-	DEBUG_SCOPE(*g_vec = vec_Create(NULL, vec_type));
+	g_allocator = p_allocator;
+	DEBUG_SCOPE(g_vec = allocator_Alloc(g_allocator, sizeof(Vec), VEC_CACHE_LINE_SIZE));
+	memset(g_vec, 0, sizeof(Vec));
+	DEBUG_SCOPE(vec_InitializeWithAllocator(g_vec, NULL, vec_type, g_allocator));
 
 	// You have to set the types that needs to be destroyed first, first
 	DEBUG_SCOPE(cpi_window_type = type_Create_Safe("CPI_Window", sizeof(CPI_Window), cpi_Window_Destructor));
@@ -241,6 +241,22 @@ void cpi_Initialize()
     DEBUG_SCOPE(result = SDL_ShaderCross_Init());
     DEBUG_ASSERT(result, "Failed to initialize SDL_ShaderCross. %s", SDL_GetError());
 }
+static void _cpi_SetFrozen(
+	Type type,
+	bool frozen)
+{
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
+	DEBUG_SCOPE(int vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, type));
+	DEBUG_ASSERT(vec_index != -1, "there is no vec with the given type");
+	DEBUG_SCOPE(Vec* p_type_vec = (Vec*)vec_GetElement_UnsafeRead(*pp_vec, vec_index, vec_type));
+	if (frozen) {
+		DEBUG_SCOPE(vec_Freeze(p_type_vec));
+	} else {
+		DEBUG_SCOPE(vec_Thaw(p_type_vec));
+	}
+	DEBUG_SCOPE(vec_MoveEnd(pp_vec));
+}
 // ===============================================================================================================
 // Window
 // ===============================================================================================================
@@ -251,12 +267,12 @@ int cpi_Window_Create(
 	const char* title)
 {
 	DEBUG_ASSERT(title, "title is NULL");
-	DEBUG_SCOPE(Vec** pp_window_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_window_vec));
-	DEBUG_SCOPE(int window_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_window_vec, cpi_window_type));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_window_vec));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_window_vec, window_vec_index, cpi_window_type));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_window_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_window_vec = vec_MoveStartUpgradable(&cursor, g_vec));
+	DEBUG_SCOPE(int window_vec_index = vec_UpsertVecWithType_UpgradableRead(*pp_window_vec, cpi_window_type));
+	DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_window_vec));
+	DEBUG_SCOPE(vec_MoveToIndexUpgradable(pp_window_vec, window_vec_index, cpi_window_type));
+	DEBUG_SCOPE(vec_UpgradeToWrite(*pp_window_vec));
 	DEBUG_SCOPE(int window_index = vec_UpsertNullElement_UnsafeWrite(*pp_window_vec, cpi_window_type));
 	DEBUG_SCOPE(CPI_Window* p_window = (CPI_Window*)vec_GetElement_UnsafeRead(*pp_window_vec, window_index, cpi_window_type));
 	DEBUG_ASSERT(p_window, "NULL pointer");
@@ -266,13 +282,10 @@ int cpi_Window_Create(
 
 	// getting gpu device
 	p_window->gpu_device_index = gpu_device_index;
-	DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int gpu_device_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_gpu_device_vec, cpi_gpu_device_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_gpu_device_vec, gpu_device_vec_index, cpi_gpu_device_type));
-	DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_gpu_device_vec, gpu_device_index, cpi_gpu_device_type));
-	DEBUG_SCOPE(DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer"));
-	DEBUG_SCOPE(ASSERT(SDL_ClaimWindowForGPUDevice(p_gpu_device->p_gpu_device, p_window->p_sdl_window), "Failed to claim window"));
-	DEBUG_SCOPE(vec_MoveEnd(pp_gpu_device_vec));
+	CPI_GPUDevice gpu_device;
+	DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_gpu_device_type, gpu_device_index, &gpu_device), "gpu device %d does not exist", gpu_device_index));
+	DEBUG_SCOPE(DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer"));
+	DEBUG_SCOPE(ASSERT(SDL_ClaimWindowForGPUDevice(gpu_device.p_gpu_device, p_window->p_sdl_window), "Failed to claim window"));
 
 	#ifdef DEBUG
 		SDL_LockMutex(g_unique_id_mutex);
@@ -290,29 +303,21 @@ void cpi_Window_Show(
     int window_index,
     int graphics_pipeline_index) 
 {
-    // get the window
-    DEBUG_SCOPE(Vec** pp_window_vec = vec_MoveStart(g_vec));
-    DEBUG_SCOPE(int window_vec_index = vec_GetVecWithType_UnsafeRead(*pp_window_vec, cpi_window_type));
-    DEBUG_SCOPE(vec_MoveToIndex(pp_window_vec, window_vec_index, cpi_window_type));
-    DEBUG_SCOPE(CPI_Window* p_window = (CPI_Window*)vec_GetElement_UnsafeRead(*pp_window_vec, window_index, cpi_window_type));
-    DEBUG_SCOPE(DEBUG_ASSERT(p_window->p_sdl_window, "NULL pointer"));
-
-    // get the gpu device
-    DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(g_vec));
-    DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_gpu_device_vec, cpi_gpu_device_type));
-    DEBUG_SCOPE(vec_MoveToIndex(pp_gpu_device_vec, gpu_device_vec_index, cpi_gpu_device_type));
-    DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_gpu_device_vec, p_window->gpu_device_index, cpi_gpu_device_type));
-    DEBUG_SCOPE(DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer"));
-
-    SDL_GPUTextureFormat color_format = SDL_GetGPUSwapchainTextureFormat(p_gpu_device->p_gpu_device, p_window->p_sdl_window);
+    // copies of the resources so that no lock is held while rendering
+    CPI_Window window;
+    DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_window_type, window_index, &window), "window %d does not exist", window_index));
+    DEBUG_SCOPE(DEBUG_ASSERT(window.p_sdl_window, "NULL pointer"));
+
+    CPI_GPUDevice gpu_device;
+    DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_gpu_device_type, window.gpu_device_index, &gpu_device), "gpu device %d does not exist", window.gpu_device_index));
+    DEBUG_SCOPE(DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer"));
+
+    SDL_GPUTextureFormat color_format = SDL_GetGPUSwapchainTextureFormat(gpu_device.p_gpu_device, window.p_sdl_window);
     DEBUG_ASSERT(SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM == color_format, "not correct color format");
 
-    // get the graphics pipeline
-    DEBUG_SCOPE(Vec** pp_graphics_pipeline_vec = vec_MoveStart(g_vec));
-    DEBUG_SCOPE(int gpu_graphics_pipeline_index = vec_GetVecWithType_UnsafeRead(*pp_graphics_pipeline_vec, cpi_graphics_pipeline_type));
-    DEBUG_SCOPE(vec_MoveToIndex(pp_graphics_pipeline_vec, gpu_graphics_pipeline_index, cpi_graphics_pipeline_type));
-    DEBUG_SCOPE(CPI_GraphicsPipeline* p_graphics_pipeline = (CPI_GraphicsPipeline*)vec_GetElement_UnsafeRead(*pp_graphics_pipeline_vec, graphics_pipeline_index, cpi_graphics_pipeline_type));
-    DEBUG_SCOPE(DEBUG_ASSERT(p_graphics_pipeline->p_graphics_pipeline, "NULL pointer"));
+    CPI_GraphicsPipeline graphics_pipeline;
+    DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_graphics_pipeline_type, graphics_pipeline_index, &graphics_pipeline), "graphics pipeline %d does not exist", graphics_pipeline_index));
+    DEBUG_SCOPE(DEBUG_ASSERT(graphics_pipeline.p_graphics_pipeline, "NULL pointer"));
 
     Rect rects[2] = {
         { 
@@ -337,21 +342,21 @@ void cpi_Window_Show(
         .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
         .size = size
     };
-    DEBUG_SCOPE(SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(p_gpu_device->p_gpu_device, &transfer_info));
+    DEBUG_SCOPE(SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device.p_gpu_device, &transfer_info));
     DEBUG_ASSERT(transfer_buffer, "Failed to create transfer buffer: %s", SDL_GetError());
 
-    DEBUG_SCOPE(void* mapped_data = SDL_MapGPUTransferBuffer(p_gpu_device->p_gpu_device, transfer_buffer, false));
+    DEBUG_SCOPE(void* mapped_data = SDL_MapGPUTransferBuffer(gpu_device.p_gpu_device, transfer_buffer, false));
     DEBUG_ASSERT(mapped_data, "Failed to map transfer buffer: %s", SDL_GetError());
     memcpy(mapped_data, rects, size);
-    DEBUG_SCOPE(SDL_UnmapGPUTransferBuffer(p_gpu_device->p_gpu_device, transfer_buffer));
+    DEBUG_SCOPE(SDL_UnmapGPUTransferBuffer(gpu_device.p_gpu_device, transfer_buffer));
     SDL_GPUBufferCreateInfo buffer_create_info = {
         .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
         .size = size
     };
 
-    DEBUG_SCOPE(SDL_GPUBuffer* gpu_buffer = SDL_CreateGPUBuffer(p_gpu_device->p_gpu_device, &buffer_create_info));
+    DEBUG_SCOPE(SDL_GPUBuffer* gpu_buffer = SDL_CreateGPUBuffer(gpu_device.p_gpu_device, &buffer_create_info));
     DEBUG_ASSERT(gpu_buffer, "Failed to create GPU buffer: %s", SDL_GetError());
-    DEBUG_SCOPE(SDL_GPUCommandBuffer* command_buffer = SDL_AcquireGPUCommandBuffer(p_gpu_device->p_gpu_device));
+    DEBUG_SCOPE(SDL_GPUCommandBuffer* command_buffer = SDL_AcquireGPUCommandBuffer(gpu_device.p_gpu_device));
     DEBUG_ASSERT(command_buffer, "Failed to acquire command buffer: %s", SDL_GetError());
     DEBUG_SCOPE(SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(command_buffer));
     SDL_GPUTransferBufferLocation source = { transfer_buffer, 0 };
@@ -359,7 +364,7 @@ void cpi_Window_Show(
     DEBUG_SCOPE(SDL_UploadToGPUBuffer(copy_pass, &source, &destination, false));
     DEBUG_SCOPE(SDL_EndGPUCopyPass(copy_pass));
     DEBUG_ASSERT(SDL_SubmitGPUCommandBuffer(command_buffer), "Failed to submit command buffer: %s", SDL_GetError());
-    SDL_ReleaseGPUTransferBuffer(p_gpu_device->p_gpu_device, transfer_buffer);
+    SDL_ReleaseGPUTransferBuffer(gpu_device.p_gpu_device, transfer_buffer);
 
 	// Load image using stb_image
     char absolute_path[PATH_MAX];
@@ -383,7 +388,7 @@ void cpi_Window_Show(
         .sample_count = SDL_GPU_SAMPLECOUNT_1,
         .props = 0
     };
-    SDL_GPUTexture* bitcoin_texture = SDL_CreateGPUTexture(p_gpu_device->p_gpu_device, &tex_info);
+    SDL_GPUTexture* bitcoin_texture = SDL_CreateGPUTexture(gpu_device.p_gpu_device, &tex_info);
     DEBUG_ASSERT(bitcoin_texture, "Failed to create bitcoin_texture: %s\n", SDL_GetError());
     
     // Create a transfer buffer sized to hold the entire image.
@@ -392,14 +397,14 @@ void cpi_Window_Show(
         .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
         .size = image_size
     };
-    SDL_GPUTransferBuffer* tex_transfer_buffer = SDL_CreateGPUTransferBuffer(p_gpu_device->p_gpu_device, &tex_transfer_info);
+    SDL_GPUTransferBuffer* tex_transfer_buffer = SDL_CreateGPUTransferBuffer(gpu_device.p_gpu_device, &tex_transfer_info);
     DEBUG_ASSERT(tex_transfer_buffer, "Failed to create transfer buffer: %s\n", SDL_GetError());
     
     // Map the transfer buffer and copy the image data into it.
-    void* tex_map = SDL_MapGPUTransferBuffer(p_gpu_device->p_gpu_device, tex_transfer_buffer, false);
+    void* tex_map = SDL_MapGPUTransferBuffer(gpu_device.p_gpu_device, tex_transfer_buffer, false);
     DEBUG_ASSERT(tex_map, "Failed to map transfer buffer: %s\n", SDL_GetError());
     memcpy(tex_map, p_data, image_size);
-    SDL_UnmapGPUTransferBuffer(p_gpu_device->p_gpu_device, tex_transfer_buffer);
+    SDL_UnmapGPUTransferBuffer(gpu_device.p_gpu_device, tex_transfer_buffer);
     
     // Define a bitcoin_texture region covering the entire bitcoin_texture.
     SDL_GPUTextureRegion tex_region = {
@@ -422,12 +427,12 @@ void cpi_Window_Show(
     };
     
     // Upload the bitcoin_texture data using a copy pass.
-    SDL_GPUCommandBuffer* tex_cmd = SDL_AcquireGPUCommandBuffer(p_gpu_device->p_gpu_device);
+    SDL_GPUCommandBuffer* tex_cmd = SDL_AcquireGPUCommandBuffer(gpu_device.p_gpu_device);
     SDL_GPUCopyPass* tex_copy = SDL_BeginGPUCopyPass(tex_cmd);
     SDL_UploadToGPUTexture(tex_copy, &tex_transfer, &tex_region, false);
     SDL_EndGPUCopyPass(tex_copy);
     SDL_SubmitGPUCommandBuffer(tex_cmd);
-    SDL_ReleaseGPUTransferBuffer(p_gpu_device->p_gpu_device, tex_transfer_buffer);
+    SDL_ReleaseGPUTransferBuffer(gpu_device.p_gpu_device, tex_transfer_buffer);
     
     // Create a bitcoin_sampler for the bitcoin_texture.
     SDL_GPUSamplerCreateInfo sampler_info = {
@@ -446,7 +451,7 @@ void cpi_Window_Show(
         .enable_compare = false,
         .props = 0
     };
-    SDL_GPUSampler* bitcoin_sampler = SDL_CreateGPUSampler(p_gpu_device->p_gpu_device, &sampler_info);
+    SDL_GPUSampler* bitcoin_sampler = SDL_CreateGPUSampler(gpu_device.p_gpu_device, &sampler_info);
     DEBUG_ASSERT(bitcoin_sampler, "Failed to create bitcoin_sampler: %s\n", SDL_GetError());
     
     // Free the loaded image data as it is now uploaded to the GPU.
@@ -463,12 +468,12 @@ void cpi_Window_Show(
         }
 
         // Acquire a command buffer for the current frame.
-        SDL_GPUCommandBuffer* cmd_buffer = SDL_AcquireGPUCommandBuffer(p_gpu_device->p_gpu_device);
+        SDL_GPUCommandBuffer* cmd_buffer = SDL_AcquireGPUCommandBuffer(gpu_device.p_gpu_device);
         DEBUG_SCOPE(ASSERT(cmd_buffer, "Failed to acquire command buffer: %s", SDL_GetError()));
 
         SDL_GPUTexture *swapchain_tex = NULL;
 	    unsigned int tex_width = 0, tex_height = 0;
-	    DEBUG_SCOPE(ASSERT(SDL_WaitAndAcquireGPUSwapchainTexture(cmd_buffer, p_window->p_sdl_window, &swapchain_tex, &tex_width, &tex_height),
+	    DEBUG_SCOPE(ASSERT(SDL_WaitAndAcquireGPUSwapchainTexture(cmd_buffer, window.p_sdl_window, &swapchain_tex, &tex_width, &tex_height),
 	                       "Failed to acquire swapchain texture: %s", SDL_GetError()));
 
 	    // Create dummy UBO data (for the vertex shader’s UBO in set 1).
@@ -513,7 +518,7 @@ void cpi_Window_Show(
         DEBUG_SCOPE(SDL_SetGPUViewport(render_pass, &viewport));
 
         // Bind the graphics pipeline.
-        DEBUG_SCOPE(SDL_BindGPUGraphicsPipeline(render_pass, p_graphics_pipeline->p_graphics_pipeline));
+        DEBUG_SCOPE(SDL_BindGPUGraphicsPipeline(render_pass, graphics_pipeline.p_graphics_pipeline));
 
         // Bind the vertex buffer.
         SDL_GPUBufferBinding buffer_binding = { .buffer = gpu_buffer, .offset = 0 };
@@ -539,7 +544,7 @@ void cpi_Window_Show(
         // SDL_Delay(16);
     }
 
-    DEBUG_SCOPE(SDL_ReleaseGPUBuffer(p_gpu_device->p_gpu_device, gpu_buffer));
+    DEBUG_SCOPE(SDL_ReleaseGPUBuffer(gpu_device.p_gpu_device, gpu_buffer));
     // (Be sure to release/destroy your dummy resources when cleaning up.)
 }
 void cpi_Window_Destructor(
@@ -548,17 +553,11 @@ void cpi_Window_Destructor(
 	CPI_Window* p_window = (CPI_Window*)p_void;
 	DEBUG_ASSERT(p_window, "NULL pointer");
 	DEBUG_ASSERT(p_window->p_sdl_window, "NULL pointer");
-	bool is_null = true;
-	for (int i = 0; i < sizeof(CPI_ShadercCompiler); ++i) {
-		if (((unsigned char*)p_window)[i] != 0) {
-			is_null = false;
-		}
-	}
-	ASSERT(!is_null, "shaderc compiler is null");
 
 	// getting gpu device
 	/*
-	DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(g_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(&cursor, g_vec));
 	DEBUG_SCOPE(int gpu_device_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_gpu_device_vec, cpi_gpu_device_type));
 	DEBUG_SCOPE(vec_MoveToIndex(pp_gpu_device_vec, gpu_device_vec_index, cpi_gpu_device_type));
 	DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = vec_GetElement_UnsafeRead(*pp_gpu_device_vec, gpu_device_index, cpi_gpu_device_type));
@@ -574,12 +573,12 @@ void cpi_Window_Destroy(
 	int* p_window_index)
 {
 	DEBUG_ASSERT(p_window_index, "NULL pointer");
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
 	DEBUG_SCOPE(int window_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_window_type));
 	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, window_vec_index, cpi_window_type));
 	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-	DEBUG_SCOPE(CPI_Window* p_window = (CPI_Window*)vec_GetElement_UnsafeRead(*pp_vec, *p_window_index, cpi_window_type));
-	DEBUG_SCOPE(cpi_Window_Destructor(p_window));
+	DEBUG_SCOPE(vec_DestroyElement_UnsafeWrite(*pp_vec, *p_window_index, cpi_window_type));
 	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
 	DEBUG_SCOPE(vec_MoveEnd(pp_vec));
 	*p_window_index = 0;
@@ -594,26 +593,22 @@ int cpi_ShadercCompiler_GetIndex()
 	DEBUG_SCOPE(SDL_ThreadID this_thread_id = SDL_GetCurrentThreadID());
 
 	// Check if a shaderc compiler already exists for this thread
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-	DEBUG_SCOPE(int shaderc_compiler_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_vec, cpi_shaderc_compiler_type));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shaderc_compiler_vec_index, cpi_shaderc_compiler_type));
-	DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(*pp_vec));
-	if (count >= 1) {
-		for (unsigned short i = 0; i < count; ++i) {
-			DEBUG_SCOPE(CPI_ShadercCompiler* p_compiler = (CPI_ShadercCompiler*)vec_GetElement_UnsafeRead(*pp_vec, i, cpi_shaderc_compiler_type));
-			if (p_compiler[i].thread_id == this_thread_id) {
-				DEBUG_SCOPE(vec_MoveEnd(pp_vec));
-				return i;
-			}
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStartUpgradable(&cursor, g_vec));
+	DEBUG_SCOPE(int shaderc_compiler_vec_index = vec_UpsertVecWithType_UpgradableRead(*pp_vec, cpi_shaderc_compiler_type));
+	DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_vec));
+	DEBUG_SCOPE(vec_MoveToIndexUpgradable(pp_vec, shaderc_compiler_vec_index, cpi_shaderc_compiler_type));
+	for (int i = vec_GetNextLiveIndex_UnsafeRead(*pp_vec, 0); i != -1; i = vec_GetNextLiveIndex_UnsafeRead(*pp_vec, i + 1)) {
+		DEBUG_SCOPE(CPI_ShadercCompiler* p_compiler = (CPI_ShadercCompiler*)vec_GetElement_UnsafeRead(*pp_vec, i, cpi_shaderc_compiler_type));
+		if (p_compiler->thread_id == this_thread_id) {
+			DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_vec));
+			DEBUG_SCOPE(vec_MoveEnd(pp_vec));
+			return i;
 		}
 	}
 		
 	// at this point a shaderc compiler doesn't exist for this thread so the following will create it
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, -1, vec_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shaderc_compiler_vec_index, cpi_shaderc_compiler_type));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+	DEBUG_SCOPE(vec_UpgradeToWrite(*pp_vec));
 	DEBUG_SCOPE(int shaderc_compiler_index = vec_UpsertNullElement_UnsafeWrite(*pp_vec, cpi_shaderc_compiler_type));
 	DEBUG_SCOPE(CPI_ShadercCompiler* p_compiler = (CPI_ShadercCompiler*)vec_GetElement_UnsafeRead(*pp_vec, shaderc_compiler_index, cpi_shaderc_compiler_type));
 	p_compiler->thread_id = this_thread_id;
@@ -638,13 +633,7 @@ void cpi_ShadercCompiler_Destructor(
 {
 	CPI_ShadercCompiler* p_shaderc_compiler = (CPI_ShadercCompiler*)p_void;
 	DEBUG_ASSERT(p_shaderc_compiler, "NULL pointer");
-	bool is_null = true;
-	for (int i = 0; i < sizeof(CPI_ShadercCompiler); ++i) {
-		if (((unsigned char*)p_shaderc_compiler)[i] != 0) {
-			is_null = false;
-		}
-	}
-	ASSERT(!is_null, "shaderc compiler is null");
+	DEBUG_ASSERT(p_shaderc_compiler->shaderc_compiler, "NULL pointer");
     shaderc_compiler_release(p_shaderc_compiler->shaderc_compiler);
     shaderc_compile_options_release(p_shaderc_compiler->shaderc_options);
     memset(p_shaderc_compiler, 0, sizeof(CPI_ShadercCompiler));
@@ -653,11 +642,12 @@ void cpi_ShadercCompiler_Destroy(
 	int* p_shaderc_compiler_index) 
 {
     DEBUG_SCOPE(ASSERT(p_shaderc_compiler_index, "NULL pointer"));
-    DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-    DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+    Vec_Cursor cursor;
+    DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
     DEBUG_SCOPE(int shaderc_compiler_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_shaderc_compiler_type));
-    DEBUG_SCOPE(CPI_ShadercCompiler* p_compiler = (CPI_ShadercCompiler*)vec_GetElement_UnsafeRead(*pp_vec, *p_shaderc_compiler_index, cpi_shaderc_compiler_type));
-    DEBUG_SCOPE(cpi_ShadercCompiler_Destructor(p_compiler));
+    DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shaderc_compiler_vec_index, cpi_shaderc_compiler_type));
+    DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+    DEBUG_SCOPE(vec_DestroyElement_UnsafeWrite(*pp_vec, *p_shaderc_compiler_index, cpi_shaderc_compiler_type));
     DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
    	DEBUG_SCOPE(vec_MoveEnd(pp_vec));
     *p_shaderc_compiler_index = 0;
@@ -669,12 +659,16 @@ void cpi_ShadercCompiler_Destroy(
 int cpi_GPUDevice_Create() 
 {
 	ASSERT(vec_IsValid_UnsafeRead(g_vec), "invlaid vec");
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-	DEBUG_SCOPE(int gpu_device_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_vec, cpi_gpu_device_type));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, gpu_device_vec_index, cpi_gpu_device_type));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStartUpgradable(&cursor, g_vec));
+	DEBUG_SCOPE(int gpu_device_vec_index = vec_UpsertVecWithType_UpgradableRead(*pp_vec, cpi_gpu_device_type));
+	DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_vec));
+	DEBUG_SCOPE(vec_MoveToIndexUpgradable(pp_vec, gpu_device_vec_index, cpi_gpu_device_type));
+	DEBUG_SCOPE(vec_UpgradeToWrite(*pp_vec));
+	// read by every frame on every thread and written only when one is created
+	if (!vec_IsReplicatedReading(*pp_vec)) {
+		DEBUG_SCOPE(vec_SetReplicatedReading(*pp_vec, true));
+	}
 	DEBUG_SCOPE(int gpu_device_index = vec_UpsertNullElement_UnsafeWrite(*pp_vec, cpi_gpu_device_type));
 	DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_vec, gpu_device_index, cpi_gpu_device_type));
 
@@ -723,13 +717,6 @@ void cpi_GPUDevice_Destructor(
 	DEBUG_ASSERT(p_gpu_device, "NULL pointer");
 	DEBUG_ASSERT((CPI_GPUDevice*)p_gpu_device->p_gpu_device, "NULL pointer");
 
-	bool is_null = true;
-	for (int i = 0; i < sizeof(CPI_ShadercCompiler); ++i) {
-		if (((unsigned char*)p_gpu_device)[i] != 0) {
-			is_null = false;
-		}
-	}
-	ASSERT(!is_null, "shaderc compiler is null");
 	DEBUG_SCOPE(SDL_DestroyGPUDevice(p_gpu_device->p_gpu_device));
 	memset(p_gpu_device, 0, sizeof(CPI_GPUDevice));
 }
@@ -737,16 +724,24 @@ void cpi_GPUDevice_Destroy(
 	int* p_gpu_device_index) 
 {
 	DEBUG_ASSERT(p_gpu_device_index, "NULL pointer");
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
 	DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_gpu_device_type));
 	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, gpu_device_vec_index, cpi_gpu_device_type));
 	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-    DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_vec, *p_gpu_device_index, cpi_gpu_device_type));
-    DEBUG_SCOPE(cpi_GPUDevice_Destructor(p_gpu_device->p_gpu_device));
+    DEBUG_SCOPE(vec_DestroyElement_UnsafeWrite(*pp_vec, *p_gpu_device_index, cpi_gpu_device_type));
 	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
     DEBUG_SCOPE(vec_MoveEnd(pp_vec));
     *p_gpu_device_index = 0;
 }
+void cpi_GPUDevice_Freeze() 
+{
+	DEBUG_SCOPE(_cpi_SetFrozen(cpi_gpu_device_type, true));
+}
+void cpi_GPUDevice_Thaw() 
+{
+	DEBUG_SCOPE(_cpi_SetFrozen(cpi_gpu_device_type, false));
+}
 
 // ===============================================================================================================
 // Shader
@@ -768,7 +763,7 @@ unsigned long long _cpi_Shader_ReadFile(
     unsigned long long file_size = ftell(file);
     rewind(file);
 
-    DEBUG_SCOPE(*dst_buffer = (char*)alloc(NULL, file_size + 1));
+    DEBUG_SCOPE(*dst_buffer = (char*)allocator_Alloc(g_allocator, file_size + 1, 1));
     if (!*dst_buffer) {
         fclose(file);
         exit(-1);
@@ -779,7 +774,7 @@ unsigned long long _cpi_Shader_ReadFile(
     (*dst_buffer)[file_size] = '\0'; 
 
     if (readSize != file_size) {
-        free(*dst_buffer);
+        allocator_Free(g_allocator, *dst_buffer, file_size + 1);
         fclose(file);
         DEBUG_ASSERT(false, "Failed to read shader source '%s'\n", filename);
     }
@@ -893,33 +888,31 @@ void _cpi_Shader_PrintAttributeDescriptions(
     }
 }
 SDL_GPUVertexAttribute* _cpi_Shader_Create_VertexInputAttribDesc(
-	int vertex_shader_index,
+	const CPI_Shader* p_shader,
 	unsigned int* p_attribute_count, 
 	unsigned int* p_binding_stride) 
 {
+	DEBUG_ASSERT(p_shader, "NULL pointer");
 	DEBUG_ASSERT(p_attribute_count, "NULL pointer");
 	DEBUG_ASSERT(p_binding_stride, "NULL pointer");
 
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int vertex_shader_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_shader_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, vertex_shader_vec_index, cpi_shader_type));
-	DEBUG_SCOPE(CPI_Shader* p_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_vec, vertex_shader_index, cpi_shader_type));
-    DEBUG_ASSERT(p_shader->reflect_shader_module.shader_stage == SPV_REFLECT_SHADER_STAGE_VERTEX_BIT, "Provided shader is not a vertex shader\n");
+	// the caller already holds the shader vec, so the shader is passed in instead of read locking the vec a second time
+	CPI_Shader shader = *p_shader;
+    DEBUG_ASSERT(shader.reflect_shader_module.shader_stage == SPV_REFLECT_SHADER_STAGE_VERTEX_BIT, "Provided shader is not a vertex shader\n");
 
     // Enumerate input variables
     unsigned int input_var_count = 0;
-    DEBUG_SCOPE(SpvReflectResult result = spvReflectEnumerateInputVariables(&p_shader->reflect_shader_module, &input_var_count, NULL));
+    DEBUG_SCOPE(SpvReflectResult result = spvReflectEnumerateInputVariables(&shader.reflect_shader_module, &input_var_count, NULL));
     DEBUG_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS, "Failed to enumerate input variables\n");
 
-    DEBUG_SCOPE(SpvReflectInterfaceVariable** input_vars = alloc(NULL, input_var_count * sizeof(SpvReflectInterfaceVariable*)));
+    DEBUG_SCOPE(SpvReflectInterfaceVariable** input_vars = allocator_Alloc(g_allocator, input_var_count * sizeof(SpvReflectInterfaceVariable*), sizeof(void*)));
     DEBUG_ASSERT(input_vars, "Failed to allocate memory for input variables\n");
 
-    DEBUG_SCOPE(result = spvReflectEnumerateInputVariables(&p_shader->reflect_shader_module, &input_var_count, input_vars));
+    DEBUG_SCOPE(result = spvReflectEnumerateInputVariables(&shader.reflect_shader_module, &input_var_count, input_vars));
     DEBUG_ASSERT(result == SPV_REFLECT_RESULT_SUCCESS, "Failed to get input variables\n");
-    DEBUG_SCOPE(vec_MoveEnd(pp_vec));
 
     // Create an array to hold SDL_GPUVertexAttribute
-    DEBUG_SCOPE(SDL_GPUVertexAttribute* attribute_descriptions = alloc(NULL, input_var_count * sizeof(SDL_GPUVertexAttribute)));
+    DEBUG_SCOPE(SDL_GPUVertexAttribute* attribute_descriptions = allocator_Alloc(g_allocator, input_var_count * sizeof(SDL_GPUVertexAttribute), sizeof(void*)));
     DEBUG_ASSERT(attribute_descriptions, "Failed to allocate memory for vertex input attribute descriptions\n");
 
     unsigned int attribute_index = 0;
@@ -970,7 +963,7 @@ SDL_GPUVertexAttribute* _cpi_Shader_Create_VertexInputAttribDesc(
     }
 
     *p_binding_stride = offset;
-    free(input_vars);
+    allocator_Free(g_allocator, input_vars, input_var_count * sizeof(SpvReflectInterfaceVariable*));
     _cpi_Shader_PrintAttributeDescriptions(attribute_descriptions, *p_attribute_count);
 
     return attribute_descriptions;  
@@ -1083,21 +1076,18 @@ int cpi_Shader_CreateFromGlslFile(
 		shader.shaderc_compiler_index = shaderc_compiler_index;
 	}
 
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-
 	// spv code compilation
 	{
 	    DEBUG_ASSERT(!shader.p_glsl_code, "not NULL pointer");
 	    DEBUG_SCOPE(unsigned long long glsl_code_size = _cpi_Shader_ReadFile(glsl_file_path, &shader.p_glsl_code));
+	    shader.glsl_code_size = (unsigned int)glsl_code_size;
 	    DEBUG_ASSERT(shader.p_glsl_code, "NULL pointer");
-	    DEBUG_SCOPE(int shaderc_compiler_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_shaderc_compiler_type));
-	    DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shaderc_compiler_vec_index, cpi_shaderc_compiler_type));
-	    DEBUG_SCOPE(CPI_ShadercCompiler* p_shaderc_compiler = (CPI_ShadercCompiler*)vec_GetElement_UnsafeRead(*pp_vec, shader.shaderc_compiler_index, cpi_shaderc_compiler_type));
-	   	DEBUG_SCOPE(shaderc_compilation_result_t result = shaderc_compile_into_spv(p_shaderc_compiler->shaderc_compiler, shader.p_glsl_code, glsl_code_size, shader_kind, glsl_file_path, "main", p_shaderc_compiler->shaderc_options));
-	   	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, -1, vec_type));
+	    CPI_ShadercCompiler shaderc_compiler;
+	    DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_shaderc_compiler_type, shader.shaderc_compiler_index, &shaderc_compiler), "shaderc compiler %d does not exist", shader.shaderc_compiler_index));
+	   	DEBUG_SCOPE(shaderc_compilation_result_t result = shaderc_compile_into_spv(shaderc_compiler.shaderc_compiler, shader.p_glsl_code, glsl_code_size, shader_kind, glsl_file_path, "main", shaderc_compiler.shaderc_options));
 	    DEBUG_ASSERT(shaderc_result_get_compilation_status(result) == shaderc_compilation_status_success, "Shader compilation error in '%s':\n%s\n", glsl_file_path, shaderc_result_get_error_message(result));
 		DEBUG_SCOPE(shader.spv_code_size = shaderc_result_get_length(result));
-	    DEBUG_SCOPE(shader.p_spv_code = alloc(NULL, shader.spv_code_size));
+	    DEBUG_SCOPE(shader.p_spv_code = allocator_Alloc(g_allocator, shader.spv_code_size, sizeof(void*)));
 	    DEBUG_SCOPE(memcpy(shader.p_spv_code, shaderc_result_get_bytes(result), shader.spv_code_size));
 	    DEBUG_SCOPE(shaderc_result_release(result));
 	}
@@ -1139,19 +1129,14 @@ int cpi_Shader_CreateFromGlslFile(
 		    SDL_GPUShaderCreateInfo shader_info = _cpi_Shader_CreateShaderInfo(shader.p_spv_code, shader.spv_code_size, entrypoint, is_vert);
 		    
 
-	    	DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_gpu_device_type));
-	    	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, gpu_device_vec_index, cpi_gpu_device_type));
-	    	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-			DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_vec, shader.gpu_device_index, cpi_gpu_device_type));
-			DEBUG_ASSERT(p_gpu_device, "NULL pointer");
-			DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer");
+			CPI_GPUDevice gpu_device;
+			DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_gpu_device_type, shader.gpu_device_index, &gpu_device), "gpu device %d does not exist", shader.gpu_device_index));
+			DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer");
 			SDL_ShaderCross_GraphicsShaderMetadata metadata;
-		    // DEBUG_SCOPE(shader.p_sdl_shader = SDL_ShaderCross_CompileGraphicsShaderFromSPIRV(p_gpu_device->p_gpu_device, &shader_info, &metadata));
+		    // DEBUG_SCOPE(shader.p_sdl_shader = SDL_ShaderCross_CompileGraphicsShaderFromSPIRV(gpu_device.p_gpu_device, &shader_info, &metadata));
 		    // DEBUG_ASSERT(shader.p_sdl_shader, "Failed to compile Shader from SPIR-V. %s\n", SDL_GetError());
-		    DEBUG_SCOPE(shader.p_sdl_shader = SDL_CreateGPUShader(p_gpu_device->p_gpu_device, &shader_info));
+		    DEBUG_SCOPE(shader.p_sdl_shader = SDL_CreateGPUShader(gpu_device.p_gpu_device, &shader_info));
 		    DEBUG_ASSERT(shader.p_sdl_shader, "Failed to compile Shader from SPIR-V. %s\n", SDL_GetError());
-		    DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
-	    	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, -1, vec_type));
 		} 
 		// compute shader. there is no sdl shader for compute. its integrated directly into the pipeline
 		else {
@@ -1165,13 +1150,16 @@ int cpi_Shader_CreateFromGlslFile(
 		SDL_UnlockMutex(g_unique_id_mutex);
 	#endif 
 
-
-
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
-	DEBUG_SCOPE(int shader_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_vec, cpi_shader_type));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shader_vec_index, cpi_shader_type));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStartUpgradable(&cursor, g_vec));
+	DEBUG_SCOPE(int shader_vec_index = vec_UpsertVecWithType_UpgradableRead(*pp_vec, cpi_shader_type));
+	DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_vec));
+	DEBUG_SCOPE(vec_MoveToIndexUpgradable(pp_vec, shader_vec_index, cpi_shader_type));
+	DEBUG_SCOPE(vec_UpgradeToWrite(*pp_vec));
+	// read by every frame on every thread and written only when one is created
+	if (!vec_IsReplicatedReading(*pp_vec)) {
+		DEBUG_SCOPE(vec_SetReplicatedReading(*pp_vec, true));
+	}
 	DEBUG_SCOPE(int shader_index = vec_UpsertNullElement_UnsafeWrite(*pp_vec, cpi_shader_type));
 	DEBUG_SCOPE(CPI_Shader* p_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_vec, shader_index, cpi_shader_type));
 	DEBUG_ASSERT(p_shader, "NULL pointer");
@@ -1188,43 +1176,44 @@ void cpi_Shader_Destructor(
     CPI_Shader* p_shader = (CPI_Shader*)p_void;
     DEBUG_ASSERT(p_shader, "NULL pointer");
 
-    bool is_null = true;
-	for (int i = 0; i < sizeof(CPI_ShadercCompiler); ++i) {
-		if (((unsigned char*)p_shader)[i] != 0) {
-			is_null = false;
-		}
-	}
-	ASSERT(!is_null, "shaderc compiler is null");
-
     DEBUG_ASSERT(p_shader->p_glsl_code, "NULL pointer before freeing");
     DEBUG_ASSERT(p_shader->p_spv_code, "NULL pointer before freeing");
-    free(p_shader->p_glsl_code); 
-    free(p_shader->p_spv_code);
+    allocator_Free(g_allocator, p_shader->p_glsl_code, p_shader->glsl_code_size + 1);
+    allocator_Free(g_allocator, p_shader->p_spv_code, p_shader->spv_code_size);
 
     DEBUG_SCOPE(spvReflectDestroyShaderModule(&p_shader->reflect_shader_module));
 
-    DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
-    DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_gpu_device_type));
-    DEBUG_SCOPE(vec_MoveToIndex(pp_vec, gpu_device_vec_index, cpi_gpu_device_type));
-    DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_vec, p_shader->gpu_device_index, cpi_gpu_device_type));
-	DEBUG_ASSERT(p_gpu_device, "NULL pointer");
-	DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer");
-    DEBUG_SCOPE(SDL_ReleaseGPUShader(p_gpu_device->p_gpu_device, p_shader->p_sdl_shader));
-    DEBUG_SCOPE(vec_MoveToIndex(pp_vec, -1, vec_type));
+    // compute shaders never get an SDL shader
+    if (p_shader->p_sdl_shader) {
+        CPI_GPUDevice gpu_device;
+        DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_gpu_device_type, p_shader->gpu_device_index, &gpu_device), "gpu device %d does not exist", p_shader->gpu_device_index));
+        DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer");
+        DEBUG_SCOPE(SDL_ReleaseGPUShader(gpu_device.p_gpu_device, p_shader->p_sdl_shader));
+    }
     memset(p_shader, 0, sizeof(CPI_Shader));
 }
 void cpi_Shader_Destroy(
 	int* p_shader_index) 
 {
     DEBUG_ASSERT(p_shader_index, "NULL pointer");
-    DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
+    Vec_Cursor cursor;
+    DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
     DEBUG_SCOPE(int shader_vec_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_shader_type));
     DEBUG_SCOPE(vec_MoveToIndex(pp_vec, shader_vec_index, cpi_shader_type));
-	DEBUG_SCOPE(CPI_Shader* p_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_vec, *p_shader_index, cpi_shader_type));
-	DEBUG_SCOPE(cpi_Shader_Destructor(p_shader));
+    DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
+	DEBUG_SCOPE(vec_DestroyElement_UnsafeWrite(*pp_vec, *p_shader_index, cpi_shader_type));
+    DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
     DEBUG_SCOPE(vec_MoveEnd(pp_vec));
     *p_shader_index = -1;
 }
+void cpi_Shader_Freeze() 
+{
+	DEBUG_SCOPE(_cpi_SetFrozen(cpi_shader_type, true));
+}
+void cpi_Shader_Thaw() 
+{
+	DEBUG_SCOPE(_cpi_SetFrozen(cpi_shader_type, false));
+}
 
 // ===============================================================================================================
 // Graphics Pipeline
@@ -1234,21 +1223,42 @@ int cpi_GraphicsPipeline_Create(
     int fragment_shader_index,
     bool enable_debug)
 {
+	// the shaders and the gpu device cannot be destroyed while the pipeline is made from them. their vecs are looked up
+	// by the transaction while it holds the root, so the root is locked only once
+	DEBUG_SCOPE(Vec_Transaction* p_transaction = vec_Transaction_Create(g_vec));
+	DEBUG_SCOPE(int shader_entry = vec_Transaction_AddVecWithType(p_transaction, VEC_TRANSACTION_READ, cpi_shader_type));
+	DEBUG_SCOPE(int gpu_device_entry = vec_Transaction_AddVecWithType(p_transaction, VEC_TRANSACTION_READ, cpi_gpu_device_type));
+	DEBUG_SCOPE(int pipeline_entry = vec_Transaction_AddVecWithType(p_transaction, VEC_TRANSACTION_WRITE, cpi_graphics_pipeline_type));
+	DEBUG_SCOPE(vec_Transaction_Lock(p_transaction));
+	DEBUG_SCOPE(Vec* p_pipeline_vec = vec_Transaction_GetVec(p_transaction, pipeline_entry));
+	if (!p_pipeline_vec) {
+		// only the first pipeline has to create the pipeline vec, which needs the root upgradable
+		DEBUG_SCOPE(vec_Transaction_Unlock(p_transaction));
+		Vec_Cursor cursor;
+		DEBUG_SCOPE(Vec** pp_vec = vec_MoveStartUpgradable(&cursor, g_vec));
+		DEBUG_SCOPE(vec_UpsertVecWithType_UpgradableRead(*pp_vec, cpi_graphics_pipeline_type));
+		DEBUG_SCOPE(vec_DowngradeUpgradableToRead(*pp_vec));
+		DEBUG_SCOPE(vec_MoveEnd(pp_vec));
+		DEBUG_SCOPE(vec_Transaction_Lock(p_transaction));
+		DEBUG_SCOPE(p_pipeline_vec = vec_Transaction_GetVec(p_transaction, pipeline_entry));
+	}
+	DEBUG_SCOPE(Vec* p_shader_vec = vec_Transaction_GetVec(p_transaction, shader_entry));
+	DEBUG_SCOPE(Vec* p_gpu_device_vec = vec_Transaction_GetVec(p_transaction, gpu_device_entry));
+	DEBUG_ASSERT(p_shader_vec, "there are no shaders");
+	DEBUG_ASSERT(p_gpu_device_vec, "there are no gpu devices");
+	DEBUG_ASSERT(p_pipeline_vec, "NULL pointer");
 
-	DEBUG_SCOPE(Vec** pp_shader_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int shader_vec_index = vec_GetVecWithType_UnsafeRead(*pp_shader_vec, cpi_shader_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_shader_vec, shader_vec_index, cpi_shader_type));
-	DEBUG_SCOPE(CPI_Shader* p_vertex_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_shader_vec, vertex_shader_index, cpi_shader_type));
-	DEBUG_SCOPE(CPI_Shader* p_fragment_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_shader_vec, fragment_shader_index, cpi_shader_type));
+	DEBUG_SCOPE(CPI_Shader vertex_shader = *(CPI_Shader*)vec_GetElement_UnsafeRead(p_shader_vec, vertex_shader_index, cpi_shader_type));
+	DEBUG_SCOPE(CPI_Shader fragment_shader = *(CPI_Shader*)vec_GetElement_UnsafeRead(p_shader_vec, fragment_shader_index, cpi_shader_type));
 
-	DEBUG_ASSERT(p_vertex_shader->gpu_device_index == p_fragment_shader->gpu_device_index,"shaders does not contain the same gpu device\n");
-	int gpu_device_index = p_vertex_shader->gpu_device_index;
+	DEBUG_ASSERT(vertex_shader.gpu_device_index == fragment_shader.gpu_device_index,"shaders does not contain the same gpu device\n");
+	int gpu_device_index = vertex_shader.gpu_device_index;
 
 	
 	// 1. Vertex Input State
 	unsigned int vertex_attributes_count;
 	unsigned int vertex_binding_stride;
-	DEBUG_SCOPE(SDL_GPUVertexAttribute* vertex_attributes = _cpi_Shader_Create_VertexInputAttribDesc(vertex_shader_index, &vertex_attributes_count, &vertex_binding_stride));
+	DEBUG_SCOPE(SDL_GPUVertexAttribute* vertex_attributes = _cpi_Shader_Create_VertexInputAttribDesc(&vertex_shader, &vertex_attributes_count, &vertex_binding_stride));
 
 	SDL_GPUGraphicsPipelineCreateInfo pipeline_create_info = {
 		.target_info = {
@@ -1286,36 +1296,24 @@ int cpi_GraphicsPipeline_Create(
 		    .num_vertex_attributes = vertex_attributes_count,
 		},
 	    .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLESTRIP,
-	    .vertex_shader = p_vertex_shader->p_sdl_shader,
-    	.fragment_shader = p_fragment_shader->p_sdl_shader,
+	    .vertex_shader = vertex_shader.p_sdl_shader,
+    	.fragment_shader = fragment_shader.p_sdl_shader,
 	};
 	
-	DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_gpu_device_vec, cpi_gpu_device_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_gpu_device_vec, gpu_device_vec_index, cpi_gpu_device_type));
-	DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_gpu_device_vec, gpu_device_index, cpi_gpu_device_type));
-	DEBUG_ASSERT(p_gpu_device, "NULL pointer\n");
-	DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer\n");
+	DEBUG_SCOPE(CPI_GPUDevice gpu_device = *(CPI_GPUDevice*)vec_GetElement_UnsafeRead(p_gpu_device_vec, gpu_device_index, cpi_gpu_device_type));
+	DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer\n");
 
 	CPI_GraphicsPipeline pipeline = {0};
     pipeline.vertex_shader_index = vertex_shader_index;
     pipeline.fragment_shader_index = fragment_shader_index;
-	DEBUG_SCOPE(pipeline.p_graphics_pipeline = SDL_CreateGPUGraphicsPipeline(p_gpu_device->p_gpu_device, &pipeline_create_info));
+	DEBUG_SCOPE(pipeline.p_graphics_pipeline = SDL_CreateGPUGraphicsPipeline(gpu_device.p_gpu_device, &pipeline_create_info));
 	DEBUG_ASSERT(pipeline.p_graphics_pipeline, "Failed to create SDL3 graphics pipeline: %s\n", SDL_GetError());
-	DEBUG_SCOPE(vec_MoveEnd(pp_shader_vec));
-	DEBUG_SCOPE(vec_MoveEnd(pp_gpu_device_vec));
 
-	DEBUG_SCOPE(Vec** pp_pipeline_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_pipeline_vec));
-	DEBUG_SCOPE(int pipeline_vec_index = vec_UpsertVecWithType_UnsafeWrite(*pp_pipeline_vec, cpi_graphics_pipeline_type));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_pipeline_vec));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_pipeline_vec, pipeline_vec_index, cpi_graphics_pipeline_type));
-	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_pipeline_vec));
-	DEBUG_SCOPE(int pipeline_index = vec_UpsertNullElement_UnsafeWrite(*pp_pipeline_vec, cpi_graphics_pipeline_type));
-	DEBUG_SCOPE(CPI_GraphicsPipeline* p_pipeline = (CPI_GraphicsPipeline*)vec_GetElement_UnsafeRead(*pp_pipeline_vec, pipeline_index, cpi_graphics_pipeline_type));
+	DEBUG_SCOPE(int pipeline_index = vec_UpsertNullElement_UnsafeWrite(p_pipeline_vec, cpi_graphics_pipeline_type));
+	DEBUG_SCOPE(CPI_GraphicsPipeline* p_pipeline = (CPI_GraphicsPipeline*)vec_GetElement_UnsafeRead(p_pipeline_vec, pipeline_index, cpi_graphics_pipeline_type));
 	DEBUG_SCOPE(memcpy(p_pipeline, &pipeline, sizeof(CPI_GraphicsPipeline)));
-	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_pipeline_vec));
-	DEBUG_SCOPE(vec_MoveEnd(pp_pipeline_vec));
+	DEBUG_SCOPE(vec_Transaction_Unlock(p_transaction));
+	DEBUG_SCOPE(vec_Transaction_Destroy(p_transaction));
 
     printf("Graphics Pipeline created successfully.\n");
     return pipeline_index;
@@ -1326,34 +1324,27 @@ void cpi_GraphicsPipeline_Destructor(
 	CPI_GraphicsPipeline* p_graphics_pipeline = (CPI_GraphicsPipeline*)p_void;
 	DEBUG_ASSERT(p_graphics_pipeline, "NULL pointer");
 
-	DEBUG_SCOPE(Vec** pp_shader_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int shader_vec_index = vec_GetVecWithType_UnsafeRead(*pp_shader_vec, cpi_shader_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_shader_vec, shader_vec_index, cpi_shader_type));
-	DEBUG_SCOPE(CPI_Shader* p_vertex_shader = (CPI_Shader*)vec_GetElement_UnsafeRead(*pp_shader_vec, p_graphics_pipeline->vertex_shader_index, cpi_shader_type));
+	CPI_Shader vertex_shader;
+	DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_shader_type, p_graphics_pipeline->vertex_shader_index, &vertex_shader), "shader %d does not exist", p_graphics_pipeline->vertex_shader_index));
 
-	DEBUG_SCOPE(Vec** pp_gpu_device_vec = vec_MoveStart(g_vec));
-	DEBUG_SCOPE(int gpu_device_vec_index = vec_GetVecWithType_UnsafeRead(*pp_gpu_device_vec, cpi_gpu_device_type));
-	DEBUG_SCOPE(vec_MoveToIndex(pp_gpu_device_vec, gpu_device_vec_index, cpi_gpu_device_type));
-	DEBUG_SCOPE(CPI_GPUDevice* p_gpu_device = (CPI_GPUDevice*)vec_GetElement_UnsafeRead(*pp_gpu_device_vec, p_vertex_shader->gpu_device_index, cpi_gpu_device_type));
-	DEBUG_ASSERT(p_gpu_device->p_gpu_device, "NULL pointer\n");
+	CPI_GPUDevice gpu_device;
+	DEBUG_SCOPE(ASSERT(vec_CopyElementFromVecWithType_SafeRead(g_vec, cpi_gpu_device_type, vertex_shader.gpu_device_index, &gpu_device), "gpu device %d does not exist", vertex_shader.gpu_device_index));
+	DEBUG_ASSERT(gpu_device.p_gpu_device, "NULL pointer\n");
 
-	DEBUG_SCOPE(SDL_ReleaseGPUGraphicsPipeline(p_gpu_device->p_gpu_device, p_graphics_pipeline->p_graphics_pipeline));	
+	DEBUG_SCOPE(SDL_ReleaseGPUGraphicsPipeline(gpu_device.p_gpu_device, p_graphics_pipeline->p_graphics_pipeline));	
 	DEBUG_SCOPE(memset(p_graphics_pipeline, 0, sizeof(CPI_GraphicsPipeline)));
-
-	DEBUG_SCOPE(vec_MoveEnd(pp_shader_vec));
-	DEBUG_SCOPE(vec_MoveEnd(pp_gpu_device_vec));
 }
 void cpi_GraphicsPipeline_Destroy(
 	int* p_graphics_pipeline_index)
 {
 	DEBUG_ASSERT(p_graphics_pipeline_index, "NULL pointer");
-	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(g_vec));
+	Vec_Cursor cursor;
+	DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, g_vec));
 	DEBUG_SCOPE(int gpu_graphics_pipeline_index = vec_GetVecWithType_UnsafeRead(*pp_vec, cpi_graphics_pipeline_type));
 	DEBUG_SCOPE(vec_MoveToIndex(pp_vec, gpu_graphics_pipeline_index, cpi_graphics_pipeline_type));
 	DEBUG_SCOPE(vec_SwitchReadToWrite(*pp_vec));
 
-	DEBUG_SCOPE(CPI_GraphicsPipeline* p_pipeline = (CPI_GraphicsPipeline*)vec_GetElement_UnsafeRead(*pp_vec, *p_graphics_pipeline_index, cpi_graphics_pipeline_type));
-	DEBUG_SCOPE(cpi_GraphicsPipeline_Destructor(p_pipeline));
+	DEBUG_SCOPE(vec_DestroyElement_UnsafeWrite(*pp_vec, *p_graphics_pipeline_index, cpi_graphics_pipeline_type));
 
 	DEBUG_SCOPE(vec_SwitchWriteToRead(*pp_vec));
 	DEBUG_SCOPE(vec_MoveEnd(pp_vec));
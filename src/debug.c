@@ -7,11 +7,36 @@
 #include <unistd.h>
 #include <SDL3/SDL.h>
 
+void* alloc(void* ptr, size_t size) {
+    void* tmp = (ptr == NULL) ? malloc(size) : realloc(ptr, size);
+    if (!tmp) {
+        printf("Memory allocation failed\n");
+        exit(-1);
+    }
+    return tmp;
+}
+void* alloc_Aligned(void* ptr, size_t old_size, size_t size, size_t alignment) {
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t aligned_size = (size + alignment - 1) / alignment * alignment;
+    void* tmp = aligned_alloc(alignment, aligned_size > 0 ? aligned_size : alignment);
+    if (!tmp) {
+        printf("Memory allocation failed\n");
+        exit(-1);
+    }
+    // realloc does not keep the alignment so the data is moved by hand
+    if (ptr) {
+        memcpy(tmp, ptr, old_size < size ? old_size : size);
+        free(ptr);
+    }
+    return tmp;
+}
+
 #ifdef DEBUG
 	#undef printf
 	#undef malloc
 	#undef realloc
 	#undef free
+	#undef aligned_alloc
 // ===========================================================================================================================
 // Internal
 // ===========================================================================================================================
@@ -128,7 +153,7 @@ void debug_Printf(
 	unsigned int current_time = (unsigned int)(clock() * 1000 / CLOCKS_PER_SEC);
 	printf("%dms %s %s:%ld | %s", current_time-debug_data.start_time_ms, debug_data.code_location, file, line, message);
 }
-void* debug_Malloc(size_t size, size_t line, const char* file) {
+static void* _debug_TrackedMalloc(size_t alignment, size_t size, size_t line, const char* file) {
     // Expand allocation tracking array if necessary.
     while (debug_data.all_allocs_count >= debug_data.all_allocs_size) {
         size_t old_size = debug_data.all_allocs_size;
@@ -144,8 +169,8 @@ void* debug_Malloc(size_t size, size_t line, const char* file) {
         debug_data.all_allocs = tmp;
     }
 
-    // Allocate the requested memory.
-    void* ptr = malloc(size);
+    // Allocate the requested memory. alignment 0 means whatever malloc gives.
+    void* ptr = alignment ? aligned_alloc(alignment, size) : malloc(size);
     if (!ptr) {
         fprintf(stderr, "ERROR | Allocation failed at %s:%zu during malloc.\n", file, line);
         exit(EXIT_FAILURE);
@@ -169,6 +194,12 @@ void* debug_Malloc(size_t size, size_t line, const char* file) {
     debug_data.all_allocs_count++;
     return ptr;
 }
+void* debug_Malloc(size_t size, size_t line, const char* file) {
+    return _debug_TrackedMalloc(0, size, line, file);
+}
+void* debug_AlignedAlloc(size_t alignment, size_t size, size_t line, const char* file) {
+    return _debug_TrackedMalloc(alignment, size, line, file);
+}
 void* debug_Realloc(
 	void* ptr, 
 	size_t size, 
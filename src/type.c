@@ -34,6 +34,8 @@ Type type_Create_Safe(const char* type_name, Type_Size type_size, Type_Destructo
 	p_types[types_count].name = type_name;
 	p_types[types_count].size = type_size;
 	p_types[types_count].destructor = destructor;
+	p_types[types_count].p_fields = NULL;
+	p_types[types_count].fields_count = 0;
 	types_count++;
 	printf("Created type %s\n", type_name);
 	ASSERT(types_count < 65536, "there are more than 65536 types. connot support more. types_count = %d\n", types_count);
@@ -111,4 +113,42 @@ Type_Destructor type_GetDestructor_Safe(Type type) {
 	ASSERT(type_index != -1, "did not find type %d", type);
 	SDL_UnlockMutex(p_mutex);
 	return p_types[type_index].destructor;
-}
\ No newline at end of file
+}
+bool type_SetFields_Safe(Type type, const Type_Field* p_fields, unsigned int fields_count) {
+	DEBUG_ASSERT(p_fields && fields_count > 0, "a type needs at least one field");
+	SDL_LockMutex(p_mutex);
+	int type_index = -1;
+	for (int i = 0; i < types_count; ++i) {
+		if (p_types[i].type == type) {
+			type_index = i;
+		}
+	}
+	ASSERT(type_index != -1, "did not find type %d", type);
+	for (unsigned int i = 0; i < fields_count; ++i) {
+		ASSERT(p_fields[i].size > 0 && p_fields[i].offset + p_fields[i].size <= p_types[type_index].size, "field %s of type %s is outside of it", p_fields[i].name, p_types[type_index].name);
+		for (unsigned int j = 0; j < i; ++j) {
+			ASSERT(p_fields[i].offset + p_fields[i].size <= p_fields[j].offset || p_fields[j].offset + p_fields[j].size <= p_fields[i].offset, "fields %s and %s of type %s overlap", p_fields[i].name, p_fields[j].name, p_types[type_index].name);
+		}
+	}
+	bool result = !p_types[type_index].p_fields;
+	if (result) {
+		p_types[type_index].p_fields = p_fields;
+		p_types[type_index].fields_count = fields_count;
+	}
+	SDL_UnlockMutex(p_mutex);
+	return result;
+}
+const Type_Field* type_GetFields_Safe(Type type, unsigned int* p_fields_count) {
+	DEBUG_ASSERT(p_fields_count, "NULL pointer");
+	SDL_LockMutex(p_mutex);
+	int type_index = -1;
+	for (int i = 0; i < types_count; ++i) {
+		if (p_types[i].type == type) {
+			type_index = i;
+		}
+	}
+	ASSERT(type_index != -1, "did not find type %d", type);
+	*p_fields_count = p_types[type_index].fields_count;
+	SDL_UnlockMutex(p_mutex);
+	return p_types[type_index].p_fields;
+}
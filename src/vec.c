@@ -1,5 +1,11 @@
+#ifdef __linux__
+    // mremap
+    #define _GNU_SOURCE
+#endif
 #include "vec.h"
 #include "vec_path.h"
+#include "vec_arena.h"
+#include "vec_slab.h"
 #include "type.h"
 #include "debug.h"
 
@@ -7,8 +13,24 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#ifdef __linux__
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 Type vec_type = 0;
+static SDL_AtomicInt vec_next_id;
+static unsigned int vec_reader_slots_count = 1;
+
+_Static_assert(sizeof(Vec) == 2 * VEC_CACHE_LINE_SIZE, "Vec should be exactly two cache lines");
+
+// index arrays up to this long are kept on the stack instead of the heap
+#define VEC_SMALL_INDICES_COUNT 16
 
 // ================================================================================================================================
 // Fundamental
@@ -16,44 +38,626 @@ Type vec_type = 0;
     __attribute__((constructor(103)))
     void _vec_Constructor() {
         vec_type = type_Create_Safe("Vec", sizeof(Vec), vec_Destroy);
+        // a power of two so a thread finds its slot with a mask
+        int cores = SDL_GetNumLogicalCPUCores();
+        while (vec_reader_slots_count < (unsigned int)cores && vec_reader_slots_count < 256) {
+            vec_reader_slots_count *= 2;
+        }
+    }
+
+    // p_small_indices has room for VEC_SMALL_INDICES_COUNT. longer paths fall back to the heap, see _vec_FreeIndices
+    static int* _vec_GetPathIndices(const char* path, int* p_small_indices, size_t* p_indices_count) {
+        size_t indices_count = vec_Path_ToIndicesBuffer(path, p_small_indices, VEC_SMALL_INDICES_COUNT);
+        if (indices_count <= VEC_SMALL_INDICES_COUNT) {
+            *p_indices_count = indices_count;
+            return p_small_indices;
+        }
+        DEBUG_SCOPE(int* p_indices = vec_Path_ToIndices(path, p_indices_count));
+        return p_indices;
+    }
+    static int* _vec_GetIndices(size_t indices_count, int* p_small_indices) {
+        if (indices_count <= VEC_SMALL_INDICES_COUNT) {
+            return p_small_indices;
+        }
+        DEBUG_SCOPE(int* p_indices = alloc(NULL, indices_count * sizeof(int)));
+        return p_indices;
+    }
+    static void _vec_FreeIndices(int* p_indices, int* p_small_indices) {
+        if (p_indices != p_small_indices) {
+            free(p_indices);
+        }
+    }
+    static void _vec_Free(Vec* p_vec, void* ptr, size_t size) {
+        if (p_vec->p_arena) {
+            vec_Arena_Free(p_vec->p_arena, ptr);
+        } else if (p_vec->p_allocator) {
+            allocator_Free(p_vec->p_allocator, ptr, size);
+        } else if (vec_Slab_GetClassSize(size)) {
+            vec_Slab_Free(ptr, size);
+        } else {
+            DEBUG_SCOPE(free(ptr));
+        }
+    }
+    // storage of a Vec in an arena tree comes from the arena and is only given back once its root is destroyed. Vecs
+    // with an allocator of their own leave everything to it. small buffers come from the slabs otherwise, see
+    // vec_slab.h, and keep their block as long as they stay within its class.
+    // whoever frees a buffer has to pass the size it was allocated with
+    static void* _vec_Alloc(Vec* p_vec, void* ptr, size_t old_size, size_t size, size_t alignment) {
+        if (p_vec->p_arena) {
+            return vec_Arena_Alloc(p_vec->p_arena, ptr, old_size, size, alignment);
+        }
+        if (p_vec->p_allocator) {
+            return allocator_Realloc(p_vec->p_allocator, ptr, old_size, size, alignment);
+        }
+        size_t old_class_size = ptr ? vec_Slab_GetClassSize(old_size) : 0;
+        size_t class_size = vec_Slab_GetClassSize(size);
+        if (old_class_size && old_class_size == class_size) {
+            return ptr;
+        }
+        if (!old_class_size && !class_size) {
+            if (alignment > sizeof(void*)) {
+                DEBUG_SCOPE(ptr = alloc_Aligned(ptr, old_size, size, alignment));
+            } else {
+                DEBUG_SCOPE(ptr = alloc(ptr, size));
+            }
+            return ptr;
+        }
+        // moving between a slab and the heap
+        void* p_new = NULL;
+        if (class_size) {
+            p_new = vec_Slab_Alloc(size);
+        } else if (alignment > sizeof(void*)) {
+            DEBUG_SCOPE(p_new = alloc_Aligned(NULL, 0, size, alignment));
+        } else {
+            DEBUG_SCOPE(p_new = alloc(NULL, size));
+        }
+        if (ptr) {
+            memcpy(p_new, ptr, old_size < size ? old_size : size);
+            _vec_Free(p_vec, ptr, old_size);
+        }
+        return p_new;
+    }
+
+    // Types are small consecutive numbers so the index of the first child Vec of every Type is a plain array indexed by
+    // Type, -1 where there is none. It is only written with the Vec write locked
+    struct Vec_TypeIndices {
+        unsigned int    count;
+        int             p_indices[];
+    };
+    // child types are read without locking the children, but p_vec has to be locked since p_type_indices can move
+    static int _vec_FindVecWithTypeFromIndex(Vec* p_vec, Type type, size_t index) {
+        Vec_TypeIndices* p_type_indices = p_vec->p_type_indices;
+        if (p_type_indices) {
+            int type_index = type < p_type_indices->count ? p_type_indices->p_indices[type] : -1;
+            if (type_index == -1) {
+                return -1;
+            }
+            if ((size_t)type_index >= index && (size_t)type_index < p_vec->count && ((Vec*)p_vec->p_data)[type_index].type == type) {
+                return type_index;
+            }
+        }
+        // snapshots have no indices and lookups past the first child of a type have to look further
+        for (size_t i = index; i < p_vec->count; ++i) {
+            if (((Vec*)p_vec->p_data)[i].type == type) {
+                return (int)i;
+            }
+        }
+        return -1;
+    }
+    static void _vec_TypeIndices_Set(Vec* p_vec, Type type, int type_index) {
+        Vec_TypeIndices* p_type_indices = p_vec->p_type_indices;
+        if (!p_type_indices || type >= p_type_indices->count) {
+            unsigned int old_count = p_type_indices ? p_type_indices->count : 0;
+            unsigned int count = old_count ? old_count : 16;
+            while (count <= type) {
+                count *= 2;
+            }
+            size_t old_size = p_type_indices ? sizeof(Vec_TypeIndices) + old_count * sizeof(int) : 0;
+            p_type_indices = _vec_Alloc(p_vec, p_type_indices, old_size, sizeof(Vec_TypeIndices) + count * sizeof(int), sizeof(void*));
+            for (unsigned int i = old_count; i < count; ++i) {
+                p_type_indices->p_indices[i] = -1;
+            }
+            p_type_indices->count = count;
+            p_vec->p_type_indices = p_type_indices;
+        }
+        p_type_indices->p_indices[type] = type_index;
+    }
+    static int _vec_GetChildIndex(Vec* p_parent, Vec* p_child) {
+        Vec* p_children = (Vec*)p_parent->p_data;
+        if (!p_children || p_child < p_children || p_child >= p_children + p_parent->count) {
+            return -1;
+        }
+        return (int)(p_child - p_children);
+    }
+    static void _vec_TypeIndices_Add(Vec* p_parent, Vec* p_child) {
+        int index = _vec_GetChildIndex(p_parent, p_child);
+        if (index == -1) {
+            return;
+        }
+        Vec_TypeIndices* p_type_indices = p_parent->p_type_indices;
+        int type_index = p_type_indices && p_child->type < p_type_indices->count ? p_type_indices->p_indices[p_child->type] : -1;
+        if (type_index == -1 || index < type_index) {
+            DEBUG_SCOPE(_vec_TypeIndices_Set(p_parent, p_child->type, index));
+        }
+    }
+    static void _vec_TypeIndices_Remove(Vec* p_parent, Vec* p_child) {
+        int index = _vec_GetChildIndex(p_parent, p_child);
+        Vec_TypeIndices* p_type_indices = p_parent->p_type_indices;
+        if (index == -1 || !p_type_indices || p_child->type >= p_type_indices->count || p_type_indices->p_indices[p_child->type] != index) {
+            return;
+        }
+        p_type_indices->p_indices[p_child->type] = _vec_FindVecWithTypeFromIndex(p_parent, p_child->type, index + 1);
+    }
+    // after children have been moved around
+    static void _vec_TypeIndices_Rebuild(Vec* p_vec) {
+        if (p_vec->p_type_indices) {
+            for (unsigned int i = 0; i < p_vec->p_type_indices->count; ++i) {
+                p_vec->p_type_indices->p_indices[i] = -1;
+            }
+        }
+        for (size_t i = p_vec->count; i > 0; --i) {
+            Vec* p_child = (Vec*)p_vec->p_data + i - 1;
+            if (p_child->id) {
+                DEBUG_SCOPE(_vec_TypeIndices_Set(p_vec, p_child->type, (int)i - 1));
+            }
+        }
+    }
+    // the writer of a Vec holds every ancestor read locked, which is enough to bump them since generation is atomic.
+    // it has to be bumped before the Vec is unlocked, see _vec_PathCache_MoveTo
+    static void _vec_BumpGeneration(Vec* p_vec) {
+        for (; p_vec; p_vec = p_vec->p_parent) {
+            SDL_AddAtomicInt(&p_vec->generation, 1);
+        }
     }
     void vec_Initialize(Vec* p_vec, Vec* p_parent, Type type) {
     	DEBUG_ASSERT(p_vec, "NULL pointer");
         DEBUG_ASSERT(vec_IsNull_UnsafeRead(p_vec), "vec should be Null before initializing it");
     	DEBUG_ASSERT(type_IsValid_Safe(type), "type is invlaid");
         DEBUG_SCOPE(Type_Info type_info = type_GetTypeInfo_Safe(type));
-        p_vec->p_internal_lock = SDL_CreateMutex();
-    	p_vec->p_rw_lock = SDL_CreateRWLock();
-    	p_vec->p_read_lock = SDL_CreateMutex();
+        SDL_SetAtomicInt(&p_vec->lock, 0);
+        SDL_SetAtomicInt(&p_vec->sequence, 0);
+        SDL_SetAtomicInt(&p_vec->ticket, 0);
+        SDL_SetAtomicInt(&p_vec->generation, 0);
+        p_vec->growth_percent = 0;
+        p_vec->map_flags = 0;
+        p_vec->growth_chunk = 0;
+        p_vec->p_arena = p_parent ? p_parent->p_arena : NULL;
+        p_vec->p_allocator = p_parent ? p_parent->p_allocator : NULL;
+        p_vec->lock_policy = VEC_LOCK_POLICY_READ_PREFERRING;
+        p_vec->flags = 0;
+        if (p_parent && (p_parent->flags & (VEC_FLAG_COARSE | VEC_FLAG_COVERED))) {
+            p_vec->flags = VEC_FLAG_COVERED;
+        }
         p_vec->p_parent = p_parent;
     	p_vec->p_data = NULL;
-        p_vec->reading_count = 0;
-        p_vec->writing_locks = 0;
     	p_vec->type = type;
     	p_vec->count = 0;
     	p_vec->capacity = 0;
+        p_vec->id = (unsigned int)SDL_AddAtomicInt(&vec_next_id, 1) + 1;
+        p_vec->p_reader_slots = NULL;
+        p_vec->p_free_indices = NULL;
+        p_vec->free_capacity = 0;
+        p_vec->free_count = 0;
+        p_vec->p_occupancy = NULL;
+        p_vec->p_type_indices = NULL;
         ASSERT(vec_IsValid_SafeRead(p_vec), "newly created vec is invalid");
-        printf("initialized new vec %p\n", p_vec);
+        if (p_parent && p_parent->type == vec_type) {
+            DEBUG_SCOPE(_vec_TypeIndices_Add(p_parent, p_vec));
+        }
+        if (p_parent) {
+            _vec_BumpGeneration(p_parent);
+        }
+    }
+    void vec_InitializeWithArena(Vec* p_vec, Vec* p_parent, Type type, size_t chunk_size) {
+        DEBUG_ASSERT(!p_parent || !p_parent->p_arena, "p_parent = %p | arenas cannot be nested since the outer one would never destroy the inner one", p_parent);
+        DEBUG_SCOPE(vec_Initialize(p_vec, p_parent, type));
+        DEBUG_SCOPE(p_vec->p_arena = vec_Arena_Create(chunk_size));
+        p_vec->flags |= VEC_FLAG_ARENA_ROOT;
+    }
+    void vec_InitializeWithAllocator(Vec* p_vec, Vec* p_parent, Type type, const Allocator* p_allocator) {
+        DEBUG_ASSERT(!p_parent || !p_parent->p_arena, "p_parent = %p | Vecs of an arena tree allocate from the arena", p_parent);
+        DEBUG_SCOPE(vec_Initialize(p_vec, p_parent, type));
+        p_vec->p_allocator = p_allocator;
+    }
+    const Allocator* vec_GetAllocator(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (p_vec->p_arena) {
+            DEBUG_SCOPE(const Allocator* p_allocator = vec_Arena_GetAllocator(p_vec->p_arena));
+            return p_allocator;
+        }
+        return p_vec->p_allocator;
+    }
+    static size_t _vec_GetOccupancyWordsCount(size_t capacity) {
+        return (capacity + 63) / 64;
+    }
+    static size_t _vec_GetOccupancySize(size_t capacity) {
+        return _vec_GetOccupancyWordsCount(capacity) * sizeof(Uint64);
+    }
+    // grows the stack of destroyed elements to hold at least free_capacity indices
+    static void _vec_ReserveFreeIndices(Vec* p_vec, size_t free_capacity) {
+        if (free_capacity <= p_vec->free_capacity) {
+            return;
+        }
+        size_t new_capacity = p_vec->free_capacity ? p_vec->free_capacity * 2 : 8;
+        new_capacity = new_capacity < free_capacity ? free_capacity : new_capacity;
+        p_vec->p_free_indices = _vec_Alloc(p_vec, p_vec->p_free_indices, p_vec->free_capacity * sizeof(size_t), new_capacity * sizeof(size_t), sizeof(size_t));
+        p_vec->free_capacity = new_capacity;
+    }
+    static void _vec_FreeFreeIndices(Vec* p_vec) {
+        if (p_vec->p_free_indices) {
+            _vec_Free(p_vec, p_vec->p_free_indices, p_vec->free_capacity * sizeof(size_t));
+        }
+        p_vec->p_free_indices = NULL;
+        p_vec->free_capacity = 0;
+        p_vec->free_count = 0;
+    }
+    // the children from first up to but not including last have moved, so the p_parent of their own children has to follow
+    static void _vec_RelinkChildren(Vec* p_vec, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            Vec* p_child = (Vec*)p_vec->p_data + i;
+            for (size_t j = 0; p_child->id && p_child->type == vec_type && j < p_child->count; ++j) {
+                Vec* p_grandchild = (Vec*)p_child->p_data + j;
+                if (p_grandchild->id) {
+                    p_grandchild->p_parent = p_child;
+                }
+            }
+        }
+    }
+#ifdef __linux__
+    static size_t _vec_GetMappedSize(size_t size) {
+        size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+        return (size + page_size - 1) & ~(page_size - 1);
+    }
+    // huge pages only back ranges that start on a huge page, which mmap does not promise, so a huge page more is mapped
+    // and the ends are cut off again. flags are added to the flags of the mmap
+    static void* _vec_MapHugeAligned(size_t size, int flags) {
+        size_t mapped_size = _vec_GetMappedSize(size);
+        unsigned char* p_map = mmap(NULL, mapped_size + VEC_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if (p_map == MAP_FAILED) {
+            return MAP_FAILED;
+        }
+        unsigned char* p_aligned = (unsigned char*)(((uintptr_t)p_map + VEC_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(VEC_HUGE_PAGE_SIZE - 1));
+        if (p_aligned > p_map) {
+            munmap(p_map, (size_t)(p_aligned - p_map));
+        }
+        size_t tail_size = (size_t)(p_map + VEC_HUGE_PAGE_SIZE - p_aligned);
+        if (tail_size) {
+            munmap(p_aligned + mapped_size, tail_size);
+        }
+        return p_aligned;
+    }
+    // applies the map_flags to the first size bytes of a mapping, of which the pages from first up to last are faulted in.
+    // touching a page writes back the byte it read so it works on pages that already hold elements as well
+    static void _vec_AdviseMapped(Vec* p_vec, unsigned char* p_map, size_t size, size_t first, size_t last) {
+#ifdef MADV_HUGEPAGE
+        if (p_vec->map_flags & VEC_MAP_HUGE_PAGES) {
+            madvise(p_map, _vec_GetMappedSize(size), MADV_HUGEPAGE);
+        }
+#endif
+        if (!(p_vec->map_flags & VEC_MAP_PREFAULT)) {
+            return;
+        }
+        size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+        first &= ~(page_size - 1);
+        last = _vec_GetMappedSize(last);
+        if (first >= last) {
+            return;
+        }
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(p_map + first, last - first, MADV_POPULATE_WRITE) == 0) {
+            return;
+        }
+#endif
+        // kernels before 5.14 cannot populate on request
+        volatile unsigned char* p_pages = p_map;
+        for (size_t offset = first; offset < last; offset += page_size) {
+            p_pages[offset] = p_pages[offset];
+        }
+    }
+    // mapped storage is grown and shrunk by remapping its pages, which never copies them. pages are only backed by
+    // memory once they are written, unless the Vec asked for VEC_MAP_PREFAULT. mappings are page aligned so child Vecs
+    // stay on cache line boundaries
+    static void _vec_ReallocMapped(Vec* p_vec, size_t old_size, size_t size) {
+        unsigned char* p_data = NULL;
+        if (size >= VEC_MAP_THRESHOLD) {
+            void* p_map;
+            size_t mapped_size = 0;
+            if (p_vec->flags & VEC_FLAG_MAPPED) {
+                mapped_size = _vec_GetMappedSize(old_size);
+                if (p_vec->map_flags & VEC_MAP_HUGE_PAGES) {
+                    // wherever mremap moves the pages to is only page aligned, so they either grow in place or are moved
+                    // onto a huge page aligned mapping that they replace
+                    p_map = mremap(p_vec->p_data, mapped_size, _vec_GetMappedSize(size), 0);
+                    if (p_map == MAP_FAILED) {
+                        p_map = _vec_MapHugeAligned(size, 0);
+                    }
+                    if (p_map != MAP_FAILED && p_map != p_vec->p_data) {
+                        p_map = mremap(p_vec->p_data, mapped_size, _vec_GetMappedSize(size), MREMAP_MAYMOVE | MREMAP_FIXED, p_map);
+                    }
+                } else {
+                    p_map = mremap(p_vec->p_data, mapped_size, _vec_GetMappedSize(size), MREMAP_MAYMOVE);
+                }
+            } else {
+                if (p_vec->map_flags & VEC_MAP_HUGE_PAGES) {
+                    p_map = _vec_MapHugeAligned(size, 0);
+                } else {
+                    p_map = mmap(NULL, _vec_GetMappedSize(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                }
+                if (p_map != MAP_FAILED && p_vec->p_data) {
+                    memcpy(p_map, p_vec->p_data, old_size);
+                    _vec_Free(p_vec, p_vec->p_data, old_size);
+                }
+            }
+            ASSERT(p_map != MAP_FAILED, "p_vec = %p | failed to map %zu bytes", p_vec, size);
+            p_data = p_map;
+            p_vec->flags |= VEC_FLAG_MAPPED;
+            // pages that were mapped before are faulted in already if they had to be
+            if (p_vec->map_flags && size > mapped_size) {
+                _vec_AdviseMapped(p_vec, p_data, size, mapped_size, size);
+            }
+        } else {
+            // small enough for the heap again
+            if (size > 0) {
+                p_data = _vec_Alloc(p_vec, NULL, 0, size, p_vec->type == vec_type ? VEC_CACHE_LINE_SIZE : sizeof(void*));
+                memcpy(p_data, p_vec->p_data, size);
+            }
+            munmap(p_vec->p_data, _vec_GetMappedSize(old_size));
+            p_vec->flags &= ~VEC_FLAG_MAPPED;
+        }
+        p_vec->p_data = p_data;
+    }
+#endif
+    // the columns of a columnar Vec are laid out in the order of the fields, each on a cache line of its own
+    static size_t _vec_GetColumnOffset(const Type_Field* p_fields, unsigned int field_index, size_t capacity) {
+        size_t offset = 0;
+        for (unsigned int i = 0; i < field_index; ++i) {
+            offset += (capacity * p_fields[i].size + VEC_CACHE_LINE_SIZE - 1) & ~(size_t)(VEC_CACHE_LINE_SIZE - 1);
+        }
+        return offset;
+    }
+    static size_t _vec_GetDataSize(Vec* p_vec, size_t capacity) {
+        if (p_vec->flags & VEC_FLAG_COLUMNAR) {
+            unsigned int fields_count;
+            DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+            return _vec_GetColumnOffset(p_fields, fields_count, capacity);
+        }
+        DEBUG_SCOPE(size_t size = capacity * type_GetSize_Safe(p_vec->type));
+        return size;
+    }
+    // every column moves by a different amount when the capacity changes so they are copied one by one
+    static void _vec_ReallocColumns(Vec* p_vec, size_t capacity, size_t old_size, size_t size) {
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        unsigned char* p_data = size ? _vec_Alloc(p_vec, NULL, 0, size, VEC_CACHE_LINE_SIZE) : NULL;
+        size_t count = p_vec->count < capacity ? p_vec->count : capacity;
+        for (unsigned int i = 0; p_data && p_vec->p_data && i < fields_count; ++i) {
+            memcpy(p_data + _vec_GetColumnOffset(p_fields, i, capacity), p_vec->p_data + _vec_GetColumnOffset(p_fields, i, p_vec->capacity), count * p_fields[i].size);
+        }
+        if (p_vec->p_data) {
+            _vec_Free(p_vec, p_vec->p_data, old_size);
+        }
+        p_vec->p_data = p_data;
+    }
+    // child Vecs are stored inline so their storage has to keep them on cache line boundaries
+    static void _vec_ReallocData(Vec* p_vec, size_t capacity) {
+        ASSERT(!(p_vec->flags & VEC_FLAG_STABLE), "p_vec = %p | a stable vec cannot grow past %zu elements", p_vec, p_vec->capacity);
+        unsigned char* p_old_data = p_vec->p_data;
+        size_t old_size = _vec_GetDataSize(p_vec, p_vec->capacity);
+        size_t size = _vec_GetDataSize(p_vec, capacity);
+        if (p_vec->flags & VEC_FLAG_COLUMNAR) {
+            DEBUG_SCOPE(_vec_ReallocColumns(p_vec, capacity, old_size, size));
+        } else
+#ifdef __linux__
+        // an arena is given back in one piece and an allocator decides for itself, so neither kind of tree maps storage
+        if (!p_vec->p_arena && !p_vec->p_allocator && (size >= VEC_MAP_THRESHOLD || (p_vec->flags & VEC_FLAG_MAPPED))) {
+            DEBUG_SCOPE(_vec_ReallocMapped(p_vec, old_size, size));
+        } else
+#endif
+        if (size == 0) {
+            // realloc to 0 bytes may free and give NULL, which alloc takes for running out of memory
+            if (p_vec->p_data) {
+                _vec_Free(p_vec, p_vec->p_data, old_size);
+            }
+            p_vec->p_data = NULL;
+        } else if (p_vec->type == vec_type) {
+            p_vec->p_data = _vec_Alloc(p_vec, p_vec->p_data, old_size, size, VEC_CACHE_LINE_SIZE);
+        } else {
+            p_vec->p_data = _vec_Alloc(p_vec, p_vec->p_data, old_size, size, sizeof(void*));
+        }
+        if (p_vec->type == vec_type && p_vec->p_data != p_old_data) {
+            _vec_RelinkChildren(p_vec, 0, p_vec->count < capacity ? p_vec->count : capacity);
+            _vec_BumpGeneration(p_vec);
+        }
+        if (p_vec->p_occupancy) {
+            size_t old_words_count = _vec_GetOccupancyWordsCount(p_vec->capacity);
+            size_t words_count = _vec_GetOccupancyWordsCount(capacity);
+            Uint64* p_occupancy = _vec_Alloc(p_vec, NULL, 0, _vec_GetOccupancySize(capacity), sizeof(Uint64));
+            memcpy(p_occupancy, p_vec->p_occupancy, (words_count < old_words_count ? words_count : old_words_count) * sizeof(Uint64));
+            if (words_count > old_words_count) {
+                memset(p_occupancy + old_words_count, 0, (words_count - old_words_count) * sizeof(Uint64));
+            }
+            _vec_Free(p_vec, p_vec->p_occupancy, _vec_GetOccupancySize(p_vec->capacity));
+            p_vec->p_occupancy = p_occupancy;
+        }
+    }
+    static void _vec_FreeData(Vec* p_vec) {
+#ifdef __linux__
+        if (p_vec->flags & VEC_FLAG_MAPPED) {
+            DEBUG_SCOPE(size_t size = p_vec->capacity * type_GetSize_Safe(p_vec->type));
+            munmap(p_vec->p_data, _vec_GetMappedSize(size));
+            p_vec->p_data = NULL;
+            p_vec->flags &= ~VEC_FLAG_MAPPED;
+        }
+#endif
+        if (p_vec->p_data) {
+            _vec_Free(p_vec, p_vec->p_data, _vec_GetDataSize(p_vec, p_vec->capacity));
+            p_vec->p_data = NULL;
+        }
+        if (p_vec->p_occupancy) {
+            _vec_Free(p_vec, p_vec->p_occupancy, _vec_GetOccupancySize(p_vec->capacity));
+            p_vec->p_occupancy = NULL;
+        }
+        _vec_FreeFreeIndices(p_vec);
+        if (p_vec->p_type_indices) {
+            _vec_Free(p_vec, p_vec->p_type_indices, sizeof(Vec_TypeIndices) + p_vec->p_type_indices->count * sizeof(int));
+            p_vec->p_type_indices = NULL;
+        }
+    }
+    // sets or clears the occupancy bits of the elements from first up to but not including last
+    static void _vec_SetOccupancy(Vec* p_vec, size_t first, size_t last, bool live) {
+        if (!p_vec->p_occupancy) {
+            return;
+        }
+        for (size_t i = first; i < last; ) {
+            unsigned int bit = i % 64;
+            unsigned int bits_count = last - i < 64 - bit ? (unsigned int)(last - i) : 64 - bit;
+            Uint64 mask = (bits_count == 64 ? ~(Uint64)0 : (((Uint64)1 << bits_count) - 1)) << bit;
+            if (live) {
+                p_vec->p_occupancy[i / 64] |= mask;
+            } else {
+                p_vec->p_occupancy[i / 64] &= ~mask;
+            }
+            i += bits_count;
+        }
+    }
+    static bool _vec_IsLive(Vec* p_vec, size_t index) {
+        return !p_vec->p_occupancy || ((p_vec->p_occupancy[index / 64] >> (index % 64)) & 1);
+    }
+    // bits past count are always clear so the scan can stop at the last word. SIZE_MAX when there is no live element left
+    static size_t _vec_GetNextLiveIndex(Vec* p_vec, size_t index) {
+        if (index >= p_vec->count) {
+            return SIZE_MAX;
+        }
+        if (!p_vec->p_occupancy) {
+            return index;
+        }
+        size_t words_count = _vec_GetOccupancyWordsCount(p_vec->count);
+        size_t word_index = index / 64;
+        Uint64 word = p_vec->p_occupancy[word_index] & (~(Uint64)0 << (index % 64));
+        while (!word) {
+            if (++word_index >= words_count) {
+                return SIZE_MAX;
+            }
+            word = p_vec->p_occupancy[word_index];
+        }
+        return word_index * 64 + __builtin_ctzll(word);
+    }
+    // moves the bits of count elements from first to to like memmove
+    static void _vec_MoveOccupancy(Vec* p_vec, size_t first, size_t to, size_t count) {
+        if (!p_vec->p_occupancy || first == to) {
+            return;
+        }
+        for (size_t n = 0; n < count; ++n) {
+            size_t i = to > first ? count - 1 - n : n;
+            _vec_SetOccupancy(p_vec, to + i, to + i + 1, _vec_IsLive(p_vec, first + i));
+        }
+    }
+    // the stack of destroyed elements after they have changed index
+    static void _vec_RebuildFreeIndices(Vec* p_vec) {
+        if (!p_vec->p_occupancy) {
+            return;
+        }
+        size_t words_count = _vec_GetOccupancyWordsCount(p_vec->count);
+        size_t live_count = 0;
+        for (size_t i = 0; i < words_count; ++i) {
+            live_count += __builtin_popcountll(p_vec->p_occupancy[i]);
+        }
+        _vec_ReserveFreeIndices(p_vec, p_vec->count - live_count);
+        size_t* p_free_indices = p_vec->p_free_indices;
+        p_vec->free_count = 0;
+        for (size_t i = 0; i < words_count; ++i) {
+            Uint64 word = ~p_vec->p_occupancy[i];
+            if (i == words_count - 1 && p_vec->count % 64) {
+                word &= ((Uint64)1 << (p_vec->count % 64)) - 1;
+            }
+            while (word) {
+                p_free_indices[p_vec->free_count++] = i * 64 + __builtin_ctzll(word);
+                word &= word - 1;
+            }
+        }
+    }
+    static size_t _vec_GetGrownCapacity(Vec* p_vec, size_t count) {
+        if (!p_vec->growth_percent && !p_vec->growth_chunk) {
+            size_t new_capacity = 1;
+            while (count >= new_capacity) {
+                new_capacity *= 2;
+            }
+            return new_capacity;
+        }
+        unsigned int growth_percent = p_vec->growth_percent ? p_vec->growth_percent : 200;
+        size_t new_capacity = p_vec->capacity / 100 * growth_percent + p_vec->capacity % 100 * growth_percent / 100;
+        if (new_capacity < p_vec->capacity + p_vec->growth_chunk) {
+            new_capacity = p_vec->capacity + p_vec->growth_chunk;
+        }
+        if (new_capacity < count) {
+            new_capacity = count;
+        }
+        return new_capacity;
+    }
+    static void _vec_Reserve(Vec* p_vec, size_t count) {
+        if (count > p_vec->capacity) {
+            size_t new_capacity = _vec_GetGrownCapacity(p_vec, count);
+            DEBUG_SCOPE(_vec_ReallocData(p_vec, new_capacity));
+            p_vec->capacity = new_capacity;
+        }
     }
     Vec vec_Create(Vec* p_parent, Type type) {
     	Vec vec = {0};
     	DEBUG_SCOPE(vec_Initialize(&vec, p_parent, type));
     	return vec;
     }
+    // runs the element destructors of p_vec and of every Vec below it without freeing anything, since all of their
+    // storage goes back with the arena at once. child Vecs are only walked, and Vecs of types without a destructor are
+    // not even walked
+    static void _vec_DestructArenaTree(Vec* p_vec) {
+        DEBUG_SCOPE(Type_Info type_info = type_GetTypeInfo_Safe(p_vec->type));
+        if (p_vec->type != vec_type && !type_info.destructor) {
+            return;
+        }
+        // destroyed elements were already destructed once and null child Vecs were never initialized
+        for (size_t i = _vec_GetNextLiveIndex(p_vec, 0); i != SIZE_MAX; i = _vec_GetNextLiveIndex(p_vec, i + 1)) {
+            unsigned char* p_element = p_vec->p_data + i * type_info.size;
+            if (p_vec->type != vec_type) {
+                type_info.destructor(p_element);
+            } else if (((Vec*)p_element)->id) {
+                DEBUG_SCOPE(_vec_DestructArenaTree((Vec*)p_element));
+            }
+        }
+    }
     void vec_Destroy(void* p_vec) {
         Vec* p_vec_cast = (Vec*)p_vec;
         DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec_cast), "Vec is invalid");
         DEBUG_SCOPE(vec_LockWrite(p_vec_cast));
-        DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(p_vec_cast));
         DEBUG_SCOPE(Type_Info type_info = type_GetTypeInfo_Safe(p_vec_cast->type));
         DEBUG_SCOPE(Type_Destructor type_destructor = type_info.destructor);
-        for (unsigned int i = 0; i < count; ++i) {
-            type_destructor(vec_GetElement_UnsafeRead(p_vec_cast, i, p_vec_cast->type));
+        // everything below an arena root lives in its arena, so only elements that own something else are visited
+        if (p_vec_cast->flags & VEC_FLAG_ARENA_ROOT) {
+            DEBUG_SCOPE(_vec_DestructArenaTree(p_vec_cast));
+            type_destructor = NULL;
+        }
+        // destroyed elements were already destructed once and null child Vecs were never initialized
+        for (size_t i = _vec_GetNextLiveIndex(p_vec_cast, 0); type_destructor && i != SIZE_MAX; i = _vec_GetNextLiveIndex(p_vec_cast, i + 1)) {
+            unsigned char* p_element = p_vec_cast->p_data + i * type_info.size;
+            if (p_vec_cast->type != vec_type || ((Vec*)p_element)->id) {
+                type_destructor(p_element);
+            }
+        }
+        if (!(p_vec_cast->flags & VEC_FLAG_ARENA_ROOT)) {
+            DEBUG_SCOPE(_vec_FreeData(p_vec_cast));
         }
         DEBUG_SCOPE(vec_UnlockWrite(p_vec_cast));
-        DEBUG_SCOPE(SDL_DestroyMutex(p_vec_cast->p_internal_lock));
-        DEBUG_SCOPE(SDL_DestroyMutex(p_vec_cast->p_read_lock));
-        DEBUG_SCOPE(SDL_DestroyRWLock(p_vec_cast->p_rw_lock));
+        if (p_vec_cast->p_parent && p_vec_cast->p_parent->type == vec_type) {
+            DEBUG_SCOPE(_vec_TypeIndices_Remove(p_vec_cast->p_parent, p_vec_cast));
+        }
+        if (p_vec_cast->p_parent) {
+            _vec_BumpGeneration(p_vec_cast->p_parent);
+        }
+        if (p_vec_cast->p_reader_slots) {
+            _vec_Free(p_vec_cast, p_vec_cast->p_reader_slots, vec_reader_slots_count * sizeof(Vec_ReaderSlot));
+        }
+        if (p_vec_cast->flags & VEC_FLAG_ARENA_ROOT) {
+            DEBUG_SCOPE(vec_Arena_Destroy(p_vec_cast->p_arena));
+        }
         memset(p_vec_cast, 0, sizeof(Vec));
     }
 
@@ -62,16 +666,27 @@ Type vec_type = 0;
 // ================================================================================================================================
     bool vec_IsNull_UnsafeRead(Vec* p_vec) {
         DEBUG_ASSERT(p_vec, "NULL pointer");
-        if (p_vec->p_rw_lock != NULL) {printf("p_vec->p_rw_lock != NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_read_lock != NULL) {printf("p_vec->p_read_lock != NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_internal_lock != NULL) {printf("p_vec->p_internal_lock != NULL. %p\n", p_vec); return false;}
+        if (SDL_GetAtomicInt(&p_vec->lock) != 0) {printf("p_vec->lock != 0. %p\n", p_vec); return false;}
+        if (SDL_GetAtomicInt(&p_vec->sequence) != 0) {printf("p_vec->sequence != 0. %p\n", p_vec); return false;}
+        if (SDL_GetAtomicInt(&p_vec->ticket) != 0) {printf("p_vec->ticket != 0. %p\n", p_vec); return false;}
+        if (SDL_GetAtomicInt(&p_vec->generation) != 0) {printf("p_vec->generation != 0. %p\n", p_vec); return false;}
+        if (p_vec->growth_percent != 0) {printf("p_vec->growth_percent != 0. %p\n", p_vec); return false;}
+        if (p_vec->map_flags != 0) {printf("p_vec->map_flags != 0. %p\n", p_vec); return false;}
+        if (p_vec->growth_chunk != 0) {printf("p_vec->growth_chunk != 0. %p\n", p_vec); return false;}
+        if (p_vec->lock_policy != 0) {printf("p_vec->lock_policy != 0. %p\n", p_vec); return false;}
+        if (p_vec->flags != 0) {printf("p_vec->flags != 0. %p\n", p_vec); return false;}
         if (p_vec->p_parent != NULL) {printf("p_vec->p_parent != NULL. %p\n", p_vec); return false;}
         if (p_vec->p_data != NULL) {printf("p_vec->p_data != NULL. %p\n", p_vec); return false;}
-        if (p_vec->reading_count != 0) {printf("p_vec->reading_count != 0. %p\n", p_vec); return false;}
-        if (p_vec->writing_locks != 0) {printf("p_vec->writing_locks != 0. %p\n", p_vec); return false;}
         if (p_vec->type != 0) {printf("p_vec->type == 0. %p\n", p_vec); return false;}
         if (p_vec->count != 0) {printf("p_vec->count == 0. %p\n", p_vec); return false;}
         if (p_vec->capacity != 0) {printf("p_vec->capacity == 0. %p\n", p_vec); return false;}
+        if (p_vec->id != 0) {printf("p_vec->id != 0. %p\n", p_vec); return false;}
+        if (p_vec->p_reader_slots != NULL) {printf("p_vec->p_reader_slots != NULL. %p\n", p_vec); return false;}
+        if (p_vec->p_free_indices != NULL) {printf("p_vec->p_free_indices != NULL. %p\n", p_vec); return false;}
+        if (p_vec->free_capacity != 0) {printf("p_vec->free_capacity != 0. %p\n", p_vec); return false;}
+        if (p_vec->free_count != 0) {printf("p_vec->free_count != 0. %p\n", p_vec); return false;}
+        if (p_vec->p_occupancy != NULL) {printf("p_vec->p_occupancy != NULL. %p\n", p_vec); return false;}
+        if (p_vec->p_type_indices != NULL) {printf("p_vec->p_type_indices != NULL. %p\n", p_vec); return false;}
         return true;
     }
     bool vec_IsNullAtIndices_SafeRead(Vec* p_vec, size_t indices_count, const int* p_indices) {
@@ -90,6 +705,8 @@ Type vec_type = 0;
             if (p_current->type != vec_type) {
                 if (i < indices_count-1) {
                     is_null = true; // came to element which isnt vec type when not finished with p_indices
+                } else if (!_vec_IsLive(p_current, p_indices[i])) {
+                    is_null = true; // destroyed elements are null
                 } else {
                     bool tmp_is_null = true;
                     DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_current->type));
@@ -126,13 +743,14 @@ Type vec_type = 0;
         DEBUG_ASSERT(p_vec, "NULL pointer");
         va_list args;
         va_start(args, n_args);
-        DEBUG_SCOPE(int* p_indices = alloc(NULL, n_args * sizeof(int)));
+        int p_small_indices[VEC_SMALL_INDICES_COUNT] = {0};
+        int* p_indices = _vec_GetIndices(n_args, p_small_indices);
         for (int i = 0; i < n_args; i++) {
             p_indices[i] = va_arg(args, int);
         }
         va_end(args);
         DEBUG_SCOPE(bool is_null = vec_IsNullAtIndices_SafeRead(p_vec, n_args, p_indices));
-        free(p_indices);
+        _vec_FreeIndices(p_indices, p_small_indices);
         return is_null;
     }
     void vec_Print_UnsafeRead(Vec* p_vec, unsigned int n_layers) {
@@ -140,35 +758,39 @@ Type vec_type = 0;
         DEBUG_SCOPE(vec_LockRead(p_vec));
 
         printf("Vec at %p:\n", (const void*)p_vec);
-        printf("    p_rw_lock:       %p\n", (void*)p_vec->p_rw_lock);
-        printf("    p_read_lock:     %p\n", (void*)p_vec->p_read_lock);
-        printf("    p_internal_lock: %p\n", (void*)p_vec->p_internal_lock);
-        printf("    reading_count:   %p\n", p_vec->reading_count);
-        printf("    writing_locks:   %p\n", p_vec->writing_locks);
+        printf("    lock:            %08x\n", (unsigned int)SDL_GetAtomicInt(&p_vec->lock));
+        printf("    sequence:        %u\n", (unsigned int)SDL_GetAtomicInt(&p_vec->sequence));
+        printf("    ticket:          %08x\n", (unsigned int)SDL_GetAtomicInt(&p_vec->ticket));
+        printf("    generation:      %u\n", (unsigned int)SDL_GetAtomicInt(&p_vec->generation));
+        printf("    growth:          %u%% by at least %u\n", (unsigned int)p_vec->growth_percent, p_vec->growth_chunk);
+        printf("    lock_policy:     %u\n", (unsigned int)p_vec->lock_policy);
+        printf("    flags:           %02x\n", (unsigned int)p_vec->flags);
+        printf("    map_flags:       %02x\n", (unsigned int)p_vec->map_flags);
         printf("    p_data:          %p\n", p_vec->p_data);
         Type_Info info = type_GetTypeInfo_Safe(p_vec->type);
         printf("    type:            %s\n", info.name);
         printf("    type_size:       %hu\n", type_GetSize_Safe(p_vec->type));
-        printf("    count:           %u\n", p_vec->count);
-        printf("    capacity:        %u\n", p_vec->capacity);
+        printf("    count:           %zu\n", p_vec->count);
+        printf("    capacity:        %zu\n", p_vec->capacity);
+        printf("    id:              %u\n", p_vec->id);
 
         if (n_layers >= 1) {
     		if (p_vec->count >= 1) {
                 DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
     			printf("    elements:\n");
     			if (p_vec->type == vec_type) {
-    				for (unsigned int i = 0; i < p_vec->count; ++i) {
+    				for (size_t i = 0; i < p_vec->count; ++i) {
                         DEBUG_SCOPE(bool is_valid = vec_IsValid_SafeRead((Vec*)(p_vec->p_data + i*element_size)));
                         if (!is_valid) {
                             continue;
                         }
-                        printf("    %d %p:\n", i, p_vec->p_data + i*element_size);
+                        printf("    %zu %p:\n", i, p_vec->p_data + i*element_size);
     					DEBUG_SCOPE(vec_Print_UnsafeRead((Vec*)(p_vec->p_data + i*element_size), n_layers-1));
     				}
     			}
     			else {
-    				for (unsigned short i = 0; i < p_vec->count; ++i) {
-                        printf("    %d non-vec at %p:\n",  i, p_vec->p_data + i*element_size);
+    				for (size_t i = _vec_GetNextLiveIndex(p_vec, 0); i != SIZE_MAX; i = _vec_GetNextLiveIndex(p_vec, i + 1)) {
+                        printf("    %zu non-vec at %p:\n",  i, p_vec->p_data + i*element_size);
     					for (unsigned int j = 0; j < element_size; j+=8) {
     						printf("        %p\n", *((unsigned long long*)(p_vec->p_data + i*element_size+j)));
     					}
@@ -192,16 +814,17 @@ Type vec_type = 0;
         DEBUG_ASSERT(!(*pp_return_indices), "not NULL pointer");
         DEBUG_ASSERT(p_return_indices_count, "NULL pointer");
 
-        DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(p_vec));
+        Vec_Cursor cursor;
+        DEBUG_SCOPE(Vec** pp_vec = vec_MoveStart(&cursor, p_vec));
 
         bool found_match = false;
 
         do {
             DEBUG_SCOPE(Type type = vec_GetType_UnsafeRead(*pp_vec));
             DEBUG_SCOPE(Type_Size element_size = type_GetSize_Safe(type));
-            DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(*pp_vec));
+            DEBUG_SCOPE(size_t count = vec_GetCount_UnsafeRead(*pp_vec));
 
-            for (unsigned int i = 0; i < count; ++i) {
+            for (size_t i = 0; i < count; ++i) {
                 DEBUG_SCOPE(unsigned char* p_element = (unsigned char*)vec_GetElement_UnsafeRead(*pp_vec, i, (*pp_vec)->type));
                 bool match = true;
                 for (unsigned int j = 0; j < data_size && j < element_size; ++j) {
@@ -229,10 +852,10 @@ Type vec_type = 0;
                         vec_MoveToIndex(pp_vec, -1, vec_type);
                         int index = -1;
                         DEBUG_SCOPE(count = vec_GetCount_UnsafeRead(*pp_vec));
-                        for (unsigned int h = 0; h < count; ++h) {
+                        for (size_t h = 0; h < count; ++h) {
                             DEBUG_SCOPE(Vec* p_vec_tmp_2 = (Vec*)vec_GetElement_UnsafeRead(*pp_vec, h, (*pp_vec)->type));
                             if (p_vec_tmp_2 == p_vec_tmp) {
-                                index = h;
+                                index = (int)h;
                                 break;
                             }
                         }
@@ -240,7 +863,7 @@ Type vec_type = 0;
                         (*pp_return_indices)[j] = index;
                     }
                     DEBUG_ASSERT(*pp_vec == p_vec, "didnt backpropagate to correct Vec*");
-                    (*pp_return_indices)[depth-1] = i;
+                    (*pp_return_indices)[depth-1] = (int)i;
                     *p_return_indices_count = depth;
                     found_match = true;
                     break;
@@ -255,7 +878,7 @@ Type vec_type = 0;
                         printf("one iteration\n");
                         Vec* p_vec_tmp = *pp_vec;
                         DEBUG_SCOPE(vec_MoveToIndex(pp_vec, -1, vec_type));
-                        DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(*pp_vec));
+                        DEBUG_SCOPE(size_t count = vec_GetCount_UnsafeRead(*pp_vec));
                         int index = -1;
                         for (int i = 0; i < count-1; ++i) {
                             DEBUG_SCOPE(Vec* p_vec_tmp_2 = (Vec*)vec_GetElement_UnsafeRead(*pp_vec, i, (*pp_vec)->type));
@@ -304,182 +927,805 @@ Type vec_type = 0;
 
 // ================================================================================================================================
 // Custom locking
+//
+// The whole lock state of a Vec is the single word p_vec->lock:
+//     bits  0..19  number of readers holding the Vec
+//     bits 20..26  number of writers waiting for the Vec, only counted by VEC_LOCK_POLICY_WRITE_PREFERRING and by
+//                  upgraders of a VEC_LOCK_POLICY_FAIR Vec
+//     bit  27      at least one thread sleeps on the word and must be woken by the next release
+//     bit  28      an upgrader holds the Vec. it reads alongside plain readers and is the only one who can become
+//                  a writer without releasing first, so nothing can change between its read and its write
+//     bit  29      a writer holds the Vec
+// Lockers spin for a short while and then sleep on the word itself (futex on linux), so an uncontended
+// lock or unlock is a single compare and swap and a Vec owns no lock objects that need to be allocated.
+//
+// p_vec->lock_policy decides who goes first when readers and writers compete:
+//     VEC_LOCK_POLICY_READ_PREFERRING   new readers join as long as no writer holds the Vec. Writers can starve
+//     VEC_LOCK_POLICY_WRITE_PREFERRING  new readers wait while a writer is waiting. Readers can starve
+//     VEC_LOCK_POLICY_FAIR              lockers are served in arrival order through p_vec->ticket:
+//                                           bits  0..14  next ticket to hand out
+//                                           bit  15      at least one thread sleeps on the ticket word
+//                                           bits 16..30  ticket currently being served
+//
+// Readers of a replicated Vec are not counted in the lock word but in p_vec->p_reader_slots, see vec_SetReplicatedReading.
+//
+// Vecs below a coarse root are covered and never touch their own lock word or sequence. Their lock functions only check
+// that the coarse root is held in a way that allows the call and the sequence functions use the sequence of the root.
 // ================================================================================================================================
-    void vec_LockRead(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec)
-
-        SDL_LockMutex(p_vec->p_read_lock);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->writing_locks == 0, "p_vec = %p | writing_locks is not 0. That should not be possible at this line", p_vec);
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-
-        SDL_LockRWLockForReading(p_vec->p_rw_lock);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        p_vec->reading_count++;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-
-        SDL_UnlockMutex(p_vec->p_read_lock);
-    }
-    void vec_LockWrite(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-
-        SDL_LockMutex(p_vec->p_read_lock);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->reading_count == 0, "p_vec = %p | reading_count is greater than 0. That should not be possible at this line", p_vec);
-        DEBUG_ASSERT(p_vec->writing_locks == 0, "p_vec = %p | writing_locks is not 1. That should not be possible at this line", p_vec);
-        SDL_UnlockMutex(p_vec->p_internal_lock);
+    #define VEC_LOCK_READERS            0x000FFFFF
+    #define VEC_LOCK_WAITING_WRITERS    0x07F00000
+    #define VEC_LOCK_WAITING_WRITER     0x00100000
+    #define VEC_LOCK_SLEEPERS           0x08000000
+    #define VEC_LOCK_UPGRADER           0x10000000
+    #define VEC_LOCK_WRITER             0x20000000
+    #define VEC_LOCK_HELD               (VEC_LOCK_READERS | VEC_LOCK_UPGRADER | VEC_LOCK_WRITER)
+    #define VEC_LOCK_SPIN_COUNT         64
 
-        SDL_LockRWLockForWriting(p_vec->p_rw_lock);
+    #define VEC_TICKET_NEXT             0x00007FFF
+    #define VEC_TICKET_SLEEPERS         0x00008000
+    #define VEC_TICKET_SERVING          0x7FFF0000
+    #define VEC_TICKET_SERVING_SHIFT    16
 
-        SDL_LockMutex(p_vec->p_internal_lock);
-        p_vec->writing_locks++;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
+    static void _vec_Futex_Wait(SDL_AtomicInt* p_word, int expected) {
+    #ifdef __linux__
+        syscall(SYS_futex, &p_word->value, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+    #else
+        SDL_Delay(1);
+    #endif
     }
-    void vec_UnlockRead(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->reading_count >= 1, "p_vec = %p | youre trying to unlock read vec when there is no registered reading\n", p_vec);
-        DEBUG_ASSERT(p_vec->writing_locks == 0, "p_vec = %p | writing_locks is not 0. That should not be possible at this line", p_vec);
-        p_vec->reading_count--;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-        SDL_UnlockRWLock(p_vec->p_rw_lock);
+    static void _vec_Futex_WakeAll(SDL_AtomicInt* p_word) {
+    #ifdef __linux__
+        syscall(SYS_futex, &p_word->value, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+    #endif
     }
-    void vec_UnlockWrite(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->reading_count == 0, "p_vec = %p | reading_locks is greater than 0. That should not be possible at this line", p_vec);
-        DEBUG_ASSERT(p_vec->writing_locks == 1, "p_vec = %p | writing_locks is not 1. That should not be possible at this line", p_vec);
-        p_vec->writing_locks--;
-        SDL_UnlockRWLock(p_vec->p_rw_lock);
-        SDL_UnlockMutex(p_vec->p_read_lock);
-        SDL_UnlockMutex(p_vec->p_internal_lock);
+    // registers the calling thread as a sleeper and sleeps until the lock word changes from state
+    static void _vec_Lock_Sleep(Vec* p_vec, int state) {
+        if (!(state & VEC_LOCK_SLEEPERS)) {
+            if (!SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, state | VEC_LOCK_SLEEPERS)) {
+                return;
+            }
+            state |= VEC_LOCK_SLEEPERS;
+        }
+        _vec_Futex_Wait(&p_vec->lock, state);
     }
-    void vec_SwitchReadToWrite(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-        SDL_LockMutex(p_vec->p_read_lock);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->reading_count == 1, "p_vec = %p | reading_count(%d) is not 1 when switching from lock read to lock write. That should not happen here", p_vec, p_vec->reading_count);
-        DEBUG_ASSERT(p_vec->writing_locks == 0, "p_vec = %p | writing_locks(%d) is not 0 when switching from lock read to lock write. That should not happen here", p_vec, p_vec->reading_count);
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-
-        SDL_UnlockRWLock(p_vec->p_rw_lock);
-        SDL_LockRWLockForWriting(p_vec->p_rw_lock);
-
-        SDL_LockMutex(p_vec->p_internal_lock);
-        p_vec->reading_count--;
-        p_vec->writing_locks++;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
+    static void _vec_Lock_Backoff(Vec* p_vec, int state, unsigned int* p_spins) {
+        if (*p_spins < VEC_LOCK_SPIN_COUNT) {
+            (*p_spins)++;
+            SDL_CPUPauseInstruction();
+            return;
+        }
+        _vec_Lock_Sleep(p_vec, state);
     }
-    void vec_SwitchWriteToRead(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
 
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->reading_count == 0, "p_vec = %p | reading_count(%d) is not 0 when switching from lock write to lock read. That should not happen here", p_vec, p_vec->reading_count);
-        DEBUG_ASSERT(p_vec->writing_locks == 1, "p_vec = %p | writing_locks(%d) is not 1 when switching from lock write to lock read. That should not happen here", p_vec, p_vec->reading_count);
-        p_vec->reading_count++;
-        p_vec->writing_locks--;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-
-        SDL_UnlockRWLock(p_vec->p_rw_lock);
-        SDL_LockRWLockForReading(p_vec->p_rw_lock);
-        SDL_UnlockMutex(p_vec->p_read_lock);
+    // ticket word helpers used by VEC_LOCK_POLICY_FAIR
+    static int _vec_Ticket_Take(Vec* p_vec) {
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->ticket);
+            int ticket = state & VEC_TICKET_NEXT;
+            int new_state = (state & ~VEC_TICKET_NEXT) | ((ticket + 1) & VEC_TICKET_NEXT);
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->ticket, state, new_state)) {
+                return ticket;
+            }
+        }
     }
-    unsigned short vec_GetReadingLocksCount(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-        SDL_LockMutex(p_vec->p_internal_lock);
-        unsigned short reading_count = p_vec->reading_count;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-        return reading_count;
+    static void _vec_Ticket_Wait(Vec* p_vec, int ticket) {
+        unsigned int spins = 0;
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->ticket);
+            if (((state & VEC_TICKET_SERVING) >> VEC_TICKET_SERVING_SHIFT) == ticket) {
+                return;
+            }
+            if (spins < VEC_LOCK_SPIN_COUNT) {
+                spins++;
+                SDL_CPUPauseInstruction();
+                continue;
+            }
+            if (!(state & VEC_TICKET_SLEEPERS)) {
+                if (!SDL_CompareAndSwapAtomicInt(&p_vec->ticket, state, state | VEC_TICKET_SLEEPERS)) {
+                    continue;
+                }
+                state |= VEC_TICKET_SLEEPERS;
+            }
+            _vec_Futex_Wait(&p_vec->ticket, state);
+        }
     }
-    bool vec_IsWriteLocked(Vec* p_vec) {
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
-        SDL_LockMutex(p_vec->p_internal_lock);
-        DEBUG_ASSERT(p_vec->writing_locks <= 1, "p_vec = %p | writing count is greater than 1");
-        bool is_write_locked = p_vec->writing_locks == 1;
-        SDL_UnlockMutex(p_vec->p_internal_lock);
-        return is_write_locked;
+    // hands the Vec over to the next ticket once the current holder has registered itself in the lock word
+    static void _vec_Ticket_Advance(Vec* p_vec) {
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->ticket);
+            int serving = ((state & VEC_TICKET_SERVING) >> VEC_TICKET_SERVING_SHIFT) + 1;
+            int new_state = (state & VEC_TICKET_NEXT) | ((serving << VEC_TICKET_SERVING_SHIFT) & VEC_TICKET_SERVING);
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->ticket, state, new_state)) {
+                if (state & VEC_TICKET_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->ticket);
+                }
+                return;
+            }
+        }
     }
 
-// ================================================================================================================================
-// IsValid
-// ================================================================================================================================
-    bool vec_IsValid_SafeRead(Vec* p_vec) {
-        DEBUG_ASSERT(p_vec, "NULL pointer");
-        if (p_vec->p_read_lock == NULL) {printf("p_vec->p_read_lock == NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_rw_lock == NULL) {printf("p_vec->p_rw_lock == NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_internal_lock == NULL) {printf("p_vec->p_internal_lock == NULL. %p\n", p_vec); return false;}
-        DEBUG_SCOPE(vec_LockRead(p_vec));
-        if (p_vec->type == null_type) {printf("p_vec->type == 0. %p\n", p_vec); return false;}
-        if (p_vec->count > p_vec->capacity) {printf("p_vec->count > p_vec->capacity. %p\n", p_vec); return false;}
-        DEBUG_SCOPE(vec_UnlockRead(p_vec));
-        return true;
-    }    
-    bool vec_IsValid_UnsafeRead(Vec* p_vec) {
-        DEBUG_ASSERT(p_vec, "NULL pointer");
-        if (p_vec->p_read_lock == NULL) {printf("p_vec->p_read_lock == NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_rw_lock == NULL) {printf("p_vec->p_rw_lock == NULL. %p\n", p_vec); return false;}
-        if (p_vec->p_internal_lock == NULL) {
-            printf("p_vec->p_internal_lock == NULL. %p\n", p_vec); 
-            return false;
+    // joins as a reader as soon as no writer holds the Vec, ignoring waiting writers
+    static void _vec_LockRead_Barging(Vec* p_vec) {
+        unsigned int spins = 0;
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            if (state & VEC_LOCK_WRITER) {
+                _vec_Lock_Backoff(p_vec, state, &spins);
+                continue;
+            }
+            DEBUG_ASSERT((state & VEC_LOCK_READERS) != VEC_LOCK_READERS, "p_vec = %p | too many readers", p_vec);
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, state + 1)) {
+                return;
+            }
         }
-        if (p_vec->type == null_type) {printf("p_vec->type == 0. %p\n", p_vec); return false;}
-        if (p_vec->count > p_vec->capacity) {printf("p_vec->count > p_vec->capacity. %p\n", p_vec); return false;}
-        return true;
     }
-    bool vec_IsValidAtIndices_SafeRead(Vec* p_vec, Type type, size_t indices_count, const int* p_indices) {
-        DEBUG_SCOPE(bool is_valid = vec_IsValid_SafeRead(p_vec));
-        if (!is_valid) {
-            DEBUG_ASSERT(vec_IsNull_UnsafeRead(p_vec), "if vec is not valid then it should be null");
-            return false;
+    static void _vec_LockRead_WritePreferring(Vec* p_vec) {
+        unsigned int spins = 0;
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            if (state & (VEC_LOCK_WRITER | VEC_LOCK_WAITING_WRITERS)) {
+                _vec_Lock_Backoff(p_vec, state, &spins);
+                continue;
+            }
+            DEBUG_ASSERT((state & VEC_LOCK_READERS) != VEC_LOCK_READERS, "p_vec = %p | too many readers", p_vec);
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, state + 1)) {
+                return;
+            }
         }
-
-        bool is_null = false;
-        Vec* p_current = p_vec;
-        DEBUG_SCOPE(vec_LockRead(p_current));
-        int i = 0;
-        for (; i < indices_count; ++i) {
-            DEBUG_SCOPE(unsigned char* p_tmp = (unsigned char*)vec_GetElement_UnsafeRead(p_current, p_indices[i], p_current->type));
-            if (p_current->type != vec_type) {
-                if (i < indices_count-1) {
-                    printf("element is not vec type while also not the last depth which is %d\n", i+1);
-                    is_null = true; // came to element which isnt vec type when not finished with p_indices
-                } else {
-                    bool tmp_is_null = true;
-                    DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_current->type))
-                    for (int j = 0; j < element_size; ++j) {
-                        if (p_tmp[j] != 0) {
-                            tmp_is_null = false; // as long as one byte is not null then the whole element is not null
-                        }
-                    }
-                    if (tmp_is_null) {
-                        printf("element is null\n");
-                        is_null = true; // has arrived at the last index and its not a vec and its null
-                    } else if (p_current->type != type) {
-                        printf("element is not the given type\n");
-                        is_valid = false; // came to last type and its not the given type
-                    }
-                }
-                break;
+    }
+    // takes the upgrader bit once no writer or other upgrader holds the Vec. plain readers are not waited for
+    static void _vec_LockUpgradableRead_Exclusive(Vec* p_vec, int blocking) {
+        unsigned int spins = 0;
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            if (state & (VEC_LOCK_WRITER | VEC_LOCK_UPGRADER | blocking)) {
+                _vec_Lock_Backoff(p_vec, state, &spins);
+                continue;
             }
-            DEBUG_SCOPE(bool tmp_is_valid = vec_IsValid_SafeRead((Vec*)p_tmp));
-            if (!tmp_is_valid) {
-                DEBUG_ASSERT(vec_IsNull_UnsafeRead((Vec*)p_tmp), "vec should be null if its not valid");
-                printf("vec at depth %d is invalid\n", i+1);
-                is_null = true;
-                is_valid = false; 
-                break;
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, state | VEC_LOCK_UPGRADER)) {
+                return;
             }
-            p_current = (Vec*)p_tmp;
-            DEBUG_SCOPE(vec_LockRead(p_current));
         }
-        for (; i > 0; --i) {
-            DEBUG_SCOPE(vec_UnlockRead(p_current));
+    }
+    // takes the writer bit once no reader, writer or upgrader holds the Vec. held is VEC_LOCK_UPGRADER when the caller
+    // is the upgrader itself, it is then given up together with taking the writer bit. when register_waiting is set
+    // the writer counts itself as waiting in the meantime so that write preferring readers hold back
+    static void _vec_LockWrite_Exclusive(Vec* p_vec, bool register_waiting, int held) {
+        unsigned int spins = 0;
+        bool waiting = false;
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            if (state & ((VEC_LOCK_WRITER | VEC_LOCK_UPGRADER | VEC_LOCK_READERS) & ~held)) {
+                if (register_waiting && !waiting) {
+                    DEBUG_ASSERT((state & VEC_LOCK_WAITING_WRITERS) != VEC_LOCK_WAITING_WRITERS, "p_vec = %p | too many waiting writers", p_vec);
+                    waiting = SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, state + VEC_LOCK_WAITING_WRITER);
+                    continue;
+                }
+                _vec_Lock_Backoff(p_vec, state, &spins);
+                continue;
+            }
+            int new_state = (state & ~held) | VEC_LOCK_WRITER;
+            if (waiting) {
+                new_state -= VEC_LOCK_WAITING_WRITER;
+            }
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                SDL_AddAtomicInt(&p_vec->sequence, 1);
+                return;
+            }
+        }
+    }
+    // frozen Vecs are never written so whoever sees the flag can read without registering. the flag can be set while a
+    // reader is on its way in, so a reader that registered has to check again and back out if it was frozen meanwhile
+    static bool _vec_IsFrozen(Vec* p_vec) {
+        return (p_vec->flags & VEC_FLAG_FROZEN) != 0;
+    }
+    static bool _vec_IsCovered(Vec* p_vec) {
+        return (p_vec->flags & VEC_FLAG_COVERED) != 0;
+    }
+    static Vec* _vec_GetCoarseRoot(Vec* p_vec) {
+        while (_vec_IsCovered(p_vec)) {
+            p_vec = p_vec->p_parent;
+        }
+        return p_vec;
+    }
+    // whoever locks a covered Vec has already locked every Vec above it, so the coarse root is never left unheld
+    __attribute__((unused))
+    static bool _vec_IsCoarseRootHeld(Vec* p_vec, int mask) {
+        Vec* p_root = _vec_GetCoarseRoot(p_vec);
+        return _vec_IsFrozen(p_root) || (SDL_GetAtomicInt(&p_root->lock) & mask) != 0;
+    }
+    static void _vec_UnlockRead(Vec* p_vec) {
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT((state & VEC_LOCK_READERS) >= 1, "p_vec = %p | youre trying to unlock read vec when there is no registered reading\n", p_vec);
+            DEBUG_ASSERT(!(state & VEC_LOCK_WRITER), "p_vec = %p | vec is write locked. That should not be possible at this line", p_vec);
+            int new_state = state - 1;
+            if ((new_state & VEC_LOCK_READERS) == 0) {
+                new_state &= ~VEC_LOCK_SLEEPERS;
+            }
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if ((state ^ new_state) & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+    static void _vec_UnlockUpgradableRead(Vec* p_vec) {
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT(state & VEC_LOCK_UPGRADER, "p_vec = %p | vec is not upgradable read locked", p_vec);
+            // everyone sleeping is woken since both writers and upgraders can be waiting for this bit
+            int new_state = state & ~(VEC_LOCK_UPGRADER | VEC_LOCK_SLEEPERS);
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if (state & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+
+    // replicated reading. a reader first counts itself in its slot and then looks for a writer, a writer first
+    // announces itself in the lock word and then looks at the slots, so at least one of them sees the other
+    static bool _vec_IsReplicated(Vec* p_vec) {
+        return (p_vec->flags & VEC_FLAG_REPLICATED) != 0;
+    }
+    // the slot belongs to the thread rather than the core it runs on, since the thread may have moved to another core by
+    // the time it unlocks
+    static SDL_AtomicInt* _vec_GetReaderSlot(Vec* p_vec) {
+        static _Thread_local int slot = -1;
+        if (slot == -1) {
+            static SDL_AtomicInt next_slot;
+            slot = SDL_AddAtomicInt(&next_slot, 1);
+        }
+        return &p_vec->p_reader_slots[(unsigned int)slot & (vec_reader_slots_count - 1)].readers;
+    }
+    static void _vec_UnlockRead_Replicated(Vec* p_vec) {
+        SDL_AtomicInt* p_slot = _vec_GetReaderSlot(p_vec);
+        DEBUG_ASSERT(SDL_GetAtomicInt(p_slot) >= 1, "p_vec = %p | youre trying to unlock read vec when there is no registered reading\n", p_vec);
+        if (SDL_AddAtomicInt(p_slot, -1) == 1 && (SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_WRITER)) {
+            _vec_Futex_WakeAll(p_slot);
+        }
+    }
+    static void _vec_LockRead_Replicated(Vec* p_vec) {
+        SDL_AtomicInt* p_slot = _vec_GetReaderSlot(p_vec);
+        unsigned int spins = 0;
+        while (true) {
+            SDL_AddAtomicInt(p_slot, 1);
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            if (!(state & VEC_LOCK_WRITER)) {
+                return;
+            }
+            _vec_UnlockRead_Replicated(p_vec);
+            while ((state = SDL_GetAtomicInt(&p_vec->lock)) & VEC_LOCK_WRITER) {
+                _vec_Lock_Backoff(p_vec, state, &spins);
+            }
+        }
+    }
+    // called by a writer that already holds the writer bit
+    static void _vec_DrainReaderSlots(Vec* p_vec) {
+        for (unsigned int i = 0; i < vec_reader_slots_count; ++i) {
+            SDL_AtomicInt* p_slot = &p_vec->p_reader_slots[i].readers;
+            unsigned int spins = 0;
+            int readers;
+            while ((readers = SDL_GetAtomicInt(p_slot)) != 0) {
+                if (spins < VEC_LOCK_SPIN_COUNT) {
+                    spins++;
+                    SDL_CPUPauseInstruction();
+                    continue;
+                }
+                _vec_Futex_Wait(p_slot, readers);
+            }
+        }
+    }
+    static void _vec_UnlockRead_Any(Vec* p_vec, bool replicated) {
+        if (replicated) {
+            _vec_UnlockRead_Replicated(p_vec);
+        } else {
+            _vec_UnlockRead(p_vec);
+        }
+    }
+    void vec_SetLockPolicy(Vec* p_vec, Vec_LockPolicy lock_policy) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(lock_policy <= VEC_LOCK_POLICY_FAIR, "lock_policy = %d is not a valid lock policy", lock_policy);
+        DEBUG_ASSERT(!_vec_IsCovered(p_vec), "p_vec = %p | covered vecs are locked through their coarse root", p_vec);
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_vec->lock) == 0, "p_vec = %p | lock policy can only be changed while nobody holds or waits for the vec", p_vec);
+        p_vec->lock_policy = (unsigned char)lock_policy;
+    }
+    Vec_LockPolicy vec_GetLockPolicy(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        return (Vec_LockPolicy)p_vec->lock_policy;
+    }
+    void vec_LockRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            DEBUG_ASSERT(_vec_IsCoarseRootHeld(p_vec, VEC_LOCK_HELD), "p_vec = %p | coarse root is not locked", p_vec);
+            return;
+        }
+        if (_vec_IsFrozen(p_vec)) {
+            return;
+        }
+        while (true) {
+            // replication only changes under the writer bit, so once registered it stays what it was when looked at
+            bool replicated = _vec_IsReplicated(p_vec);
+            if (replicated) {
+                _vec_LockRead_Replicated(p_vec);
+            } else {
+                switch (p_vec->lock_policy) {
+                    case VEC_LOCK_POLICY_READ_PREFERRING: {
+                        _vec_LockRead_Barging(p_vec);
+                        break;
+                    }
+                    case VEC_LOCK_POLICY_WRITE_PREFERRING: {
+                        _vec_LockRead_WritePreferring(p_vec);
+                        break;
+                    }
+                    case VEC_LOCK_POLICY_FAIR: {
+                        int ticket = _vec_Ticket_Take(p_vec);
+                        _vec_Ticket_Wait(p_vec, ticket);
+                        _vec_LockRead_WritePreferring(p_vec);
+                        _vec_Ticket_Advance(p_vec);
+                        break;
+                    }
+                    default: {
+                        DEBUG_ASSERT(false, "p_vec = %p | unknown lock policy %d", p_vec, p_vec->lock_policy);
+                    }
+                }
+            }
+            SDL_MemoryBarrierAcquire();
+            if (_vec_IsFrozen(p_vec)) {
+                _vec_UnlockRead_Any(p_vec, replicated);
+                return;
+            }
+            if (_vec_IsReplicated(p_vec) == replicated) {
+                return;
+            }
+            _vec_UnlockRead_Any(p_vec, replicated);
+        }
+    }
+    void vec_LockWrite(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(!_vec_IsFrozen(p_vec), "p_vec = %p | vec is frozen and cannot be written", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            DEBUG_ASSERT(_vec_IsCoarseRootHeld(p_vec, VEC_LOCK_WRITER), "p_vec = %p | coarse root has to be write locked to write a covered vec", p_vec);
+            return;
+        }
+        switch (p_vec->lock_policy) {
+            case VEC_LOCK_POLICY_READ_PREFERRING: {
+                _vec_LockWrite_Exclusive(p_vec, false, 0);
+                break;
+            }
+            case VEC_LOCK_POLICY_WRITE_PREFERRING: {
+                _vec_LockWrite_Exclusive(p_vec, true, 0);
+                break;
+            }
+            case VEC_LOCK_POLICY_FAIR: {
+                int ticket = _vec_Ticket_Take(p_vec);
+                _vec_Ticket_Wait(p_vec, ticket);
+                _vec_LockWrite_Exclusive(p_vec, false, 0);
+                _vec_Ticket_Advance(p_vec);
+                break;
+            }
+            default: {
+                DEBUG_ASSERT(false, "p_vec = %p | unknown lock policy %d", p_vec, p_vec->lock_policy);
+            }
+        }
+        if (_vec_IsReplicated(p_vec)) {
+            _vec_DrainReaderSlots(p_vec);
+        }
+    }
+    void vec_UnlockRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec) || _vec_IsFrozen(p_vec)) {
+            return;
+        }
+        _vec_UnlockRead_Any(p_vec, _vec_IsReplicated(p_vec));
+    }
+    void vec_UnlockWrite(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            return;
+        }
+        SDL_MemoryBarrierRelease();
+        SDL_AddAtomicInt(&p_vec->sequence, 1);
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT(state & VEC_LOCK_WRITER, "p_vec = %p | vec is not write locked. That should not be possible at this line", p_vec);
+            DEBUG_ASSERT((state & VEC_LOCK_READERS) == 0, "p_vec = %p | reading_locks is greater than 0. That should not be possible at this line", p_vec);
+            // only the waiting writers survive the release
+            int new_state = state & VEC_LOCK_WAITING_WRITERS;
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if (state & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+    void vec_SwitchReadToWrite(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(_vec_IsCovered(p_vec) || (SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_READERS) >= 1, "p_vec = %p | vec is not read locked when switching from lock read to lock write", p_vec);
+        DEBUG_SCOPE(vec_UnlockRead(p_vec));
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+    }
+    void vec_SwitchWriteToRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            return;
+        }
+        if (_vec_IsReplicated(p_vec)) {
+            // counted before the writer bit goes so no other writer can get in between
+            SDL_AddAtomicInt(_vec_GetReaderSlot(p_vec), 1);
+            vec_UnlockWrite(p_vec);
+            return;
+        }
+        SDL_MemoryBarrierRelease();
+        SDL_AddAtomicInt(&p_vec->sequence, 1);
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT(state & VEC_LOCK_WRITER, "p_vec = %p | vec is not write locked when switching from lock write to lock read", p_vec);
+            // waiting readers can join right away so they are woken together with everyone else
+            int new_state = ((state & ~VEC_LOCK_WRITER) & ~VEC_LOCK_SLEEPERS) + 1;
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if (state & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+    void vec_LockUpgradableRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            DEBUG_ASSERT(_vec_IsCoarseRootHeld(p_vec, VEC_LOCK_UPGRADER | VEC_LOCK_WRITER), "p_vec = %p | coarse root has to be upgradable read or write locked", p_vec);
+            return;
+        }
+        if (_vec_IsFrozen(p_vec)) {
+            return;
+        }
+        switch (p_vec->lock_policy) {
+            case VEC_LOCK_POLICY_READ_PREFERRING: {
+                _vec_LockUpgradableRead_Exclusive(p_vec, 0);
+                break;
+            }
+            case VEC_LOCK_POLICY_WRITE_PREFERRING: {
+                _vec_LockUpgradableRead_Exclusive(p_vec, VEC_LOCK_WAITING_WRITERS);
+                break;
+            }
+            case VEC_LOCK_POLICY_FAIR: {
+                int ticket = _vec_Ticket_Take(p_vec);
+                _vec_Ticket_Wait(p_vec, ticket);
+                _vec_LockUpgradableRead_Exclusive(p_vec, 0);
+                _vec_Ticket_Advance(p_vec);
+                break;
+            }
+            default: {
+                DEBUG_ASSERT(false, "p_vec = %p | unknown lock policy %d", p_vec, p_vec->lock_policy);
+            }
+        }
+        SDL_MemoryBarrierAcquire();
+        if (_vec_IsFrozen(p_vec)) {
+            _vec_UnlockUpgradableRead(p_vec);
+        }
+    }
+    void vec_UnlockUpgradableRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec) || _vec_IsFrozen(p_vec)) {
+            return;
+        }
+        _vec_UnlockUpgradableRead(p_vec);
+    }
+    void vec_UpgradeToWrite(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(!_vec_IsFrozen(p_vec), "p_vec = %p | vec is frozen and cannot be written", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            DEBUG_ASSERT(_vec_IsCoarseRootHeld(p_vec, VEC_LOCK_WRITER), "p_vec = %p | coarse root has to be write locked to write a covered vec", p_vec);
+            return;
+        }
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_UPGRADER, "p_vec = %p | vec is not upgradable read locked when upgrading to write", p_vec);
+        switch (p_vec->lock_policy) {
+            case VEC_LOCK_POLICY_READ_PREFERRING: {
+                _vec_LockWrite_Exclusive(p_vec, false, VEC_LOCK_UPGRADER);
+                break;
+            }
+            case VEC_LOCK_POLICY_WRITE_PREFERRING: {
+                _vec_LockWrite_Exclusive(p_vec, true, VEC_LOCK_UPGRADER);
+                break;
+            }
+            case VEC_LOCK_POLICY_FAIR: {
+                // no ticket since a writer being served could be waiting for this very upgrader. counting as a
+                // waiting writer stalls the reader being served instead, so the queue waits behind the upgrade
+                _vec_LockWrite_Exclusive(p_vec, true, VEC_LOCK_UPGRADER);
+                break;
+            }
+            default: {
+                DEBUG_ASSERT(false, "p_vec = %p | unknown lock policy %d", p_vec, p_vec->lock_policy);
+            }
+        }
+        if (_vec_IsReplicated(p_vec)) {
+            _vec_DrainReaderSlots(p_vec);
+        }
+    }
+    void vec_DowngradeWriteToUpgradable(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            return;
+        }
+        SDL_MemoryBarrierRelease();
+        SDL_AddAtomicInt(&p_vec->sequence, 1);
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT(state & VEC_LOCK_WRITER, "p_vec = %p | vec is not write locked when downgrading to upgradable read", p_vec);
+            int new_state = (state & ~(VEC_LOCK_WRITER | VEC_LOCK_SLEEPERS)) | VEC_LOCK_UPGRADER;
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if (state & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+    void vec_DowngradeUpgradableToRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec) || _vec_IsFrozen(p_vec)) {
+            return;
+        }
+        if (_vec_IsReplicated(p_vec)) {
+            // no writer can come in while the upgrader bit is held, so the slot can be counted first
+            SDL_AddAtomicInt(_vec_GetReaderSlot(p_vec), 1);
+            _vec_UnlockUpgradableRead(p_vec);
+            return;
+        }
+        while (true) {
+            int state = SDL_GetAtomicInt(&p_vec->lock);
+            DEBUG_ASSERT(state & VEC_LOCK_UPGRADER, "p_vec = %p | vec is not upgradable read locked when downgrading to read", p_vec);
+            DEBUG_ASSERT((state & VEC_LOCK_READERS) != VEC_LOCK_READERS, "p_vec = %p | too many readers", p_vec);
+            int new_state = (state & ~(VEC_LOCK_UPGRADER | VEC_LOCK_SLEEPERS)) + 1;
+            if (SDL_CompareAndSwapAtomicInt(&p_vec->lock, state, new_state)) {
+                if (state & VEC_LOCK_SLEEPERS) {
+                    _vec_Futex_WakeAll(&p_vec->lock);
+                }
+                return;
+            }
+        }
+    }
+    bool vec_IsUpgradableReadLocked(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsCovered(p_vec)) {
+            // a written coarse root lets its covered Vecs be used as if they were upgradable read locked
+            p_vec = _vec_GetCoarseRoot(p_vec);
+            return _vec_IsFrozen(p_vec) || (SDL_GetAtomicInt(&p_vec->lock) & (VEC_LOCK_UPGRADER | VEC_LOCK_WRITER)) != 0;
+        }
+        return _vec_IsFrozen(p_vec) || (SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_UPGRADER) != 0;
+    }
+    unsigned short vec_GetReadingLocksCount(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        p_vec = _vec_GetCoarseRoot(p_vec);
+        int readers = SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_READERS;
+        if (p_vec->p_reader_slots) {
+            for (unsigned int i = 0; i < vec_reader_slots_count; ++i) {
+                readers += SDL_GetAtomicInt(&p_vec->p_reader_slots[i].readers);
+            }
+        }
+        return (unsigned short)readers;
+    }
+    bool vec_IsWriteLocked(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        p_vec = _vec_GetCoarseRoot(p_vec);
+        return (SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_WRITER) != 0;
+    }
+
+// ================================================================================================================================
+// Freezing
+// ================================================================================================================================
+    void vec_Freeze(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (_vec_IsFrozen(p_vec)) {
+            return;
+        }
+        // the write lock waits out every reader that registered before the flag is set
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+        if (p_vec->type == vec_type) {
+            for (size_t i = 0; i < p_vec->count; ++i) {
+                Vec* p_child = (Vec*)p_vec->p_data + i;
+                if (p_child->type != null_type) {
+                    DEBUG_SCOPE(vec_Freeze(p_child));
+                }
+            }
+        }
+        p_vec->flags |= VEC_FLAG_FROZEN;
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
+    void vec_Thaw(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT((SDL_GetAtomicInt(&p_vec->lock) & ~VEC_LOCK_SLEEPERS) == 0, "p_vec = %p | frozen vec should not be locked", p_vec);
+        if (!_vec_IsFrozen(p_vec)) {
+            return;
+        }
+        p_vec->flags &= ~VEC_FLAG_FROZEN;
+        SDL_MemoryBarrierRelease();
+        if (p_vec->type == vec_type) {
+            for (size_t i = 0; i < p_vec->count; ++i) {
+                Vec* p_child = (Vec*)p_vec->p_data + i;
+                if (p_child->type != null_type) {
+                    DEBUG_SCOPE(vec_Thaw(p_child));
+                }
+            }
+        }
+    }
+    bool vec_IsFrozen(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        return _vec_IsFrozen(p_vec);
+    }
+
+// ================================================================================================================================
+// Lock granularity
+// ================================================================================================================================
+    // nobody can hold a Vec below a write locked one, so their lock words can be handed over to the coarse root
+    static void _vec_SetCovered(Vec* p_vec, bool covered) {
+        if (p_vec->type != vec_type) {
+            return;
+        }
+        for (size_t i = 0; i < p_vec->count; ++i) {
+            Vec* p_child = (Vec*)p_vec->p_data + i;
+            if (p_child->type == null_type) {
+                continue;
+            }
+            DEBUG_ASSERT((SDL_GetAtomicInt(&p_child->lock) & ~VEC_LOCK_SLEEPERS) == 0, "p_vec = %p | vec below a write locked vec should not be locked", p_child);
+            // a coarse root further down is swallowed by this one
+            p_child->flags &= ~(VEC_FLAG_COARSE | VEC_FLAG_COVERED);
+            if (covered) {
+                p_child->flags |= VEC_FLAG_COVERED;
+            }
+            DEBUG_SCOPE(_vec_SetCovered(p_child, covered));
+        }
+    }
+    void vec_SetLockGranularity(Vec* p_vec, Vec_LockGranularity lock_granularity) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(lock_granularity <= VEC_LOCK_GRANULARITY_COARSE, "lock_granularity = %d is not a valid lock granularity", lock_granularity);
+        DEBUG_ASSERT(!_vec_IsCovered(p_vec), "p_vec = %p | covered vecs take the lock granularity of their coarse root", p_vec);
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_WRITER, "p_vec = %p | lock granularity can only be changed while the vec is write locked", p_vec);
+        if (lock_granularity == VEC_LOCK_GRANULARITY_COARSE) {
+            p_vec->flags |= VEC_FLAG_COARSE;
+        } else {
+            p_vec->flags &= ~VEC_FLAG_COARSE;
+        }
+        DEBUG_SCOPE(_vec_SetCovered(p_vec, lock_granularity == VEC_LOCK_GRANULARITY_COARSE));
+    }
+    Vec_LockGranularity vec_GetLockGranularity(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        if (p_vec->flags & (VEC_FLAG_COARSE | VEC_FLAG_COVERED)) {
+            return VEC_LOCK_GRANULARITY_COARSE;
+        }
+        return VEC_LOCK_GRANULARITY_PER_NODE;
+    }
+
+// ================================================================================================================================
+// Replicated reading
+// ================================================================================================================================
+    void vec_SetReplicatedReading(Vec* p_vec, bool replicated) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        DEBUG_ASSERT(!_vec_IsCovered(p_vec), "p_vec = %p | covered vecs are read through their coarse root", p_vec);
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_vec->lock) & VEC_LOCK_WRITER, "p_vec = %p | replication can only be switched while the vec is write locked", p_vec);
+        if (!replicated) {
+            // the slots are kept until the vec is destroyed since a reader may still be on its way to one
+            p_vec->flags &= ~VEC_FLAG_REPLICATED;
+            return;
+        }
+        if (!p_vec->p_reader_slots) {
+            size_t size = vec_reader_slots_count * sizeof(Vec_ReaderSlot);
+            p_vec->p_reader_slots = _vec_Alloc(p_vec, NULL, 0, size, VEC_CACHE_LINE_SIZE);
+            memset(p_vec->p_reader_slots, 0, size);
+        }
+        SDL_MemoryBarrierRelease();
+        p_vec->flags |= VEC_FLAG_REPLICATED;
+    }
+    bool vec_IsReplicatedReading(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec = %p is invalid\n", p_vec);
+        return _vec_IsReplicated(p_vec);
+    }
+
+// ================================================================================================================================
+// Copying elements
+// ================================================================================================================================
+    bool vec_CopyElementFromVecWithType_SafeRead(Vec* p_vec, Type type, int index, void* p_dst) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid");
+        DEBUG_ASSERT(p_vec->type == vec_type, "type of provided vec has to be vec_type");
+        DEBUG_ASSERT(p_dst, "NULL pointer");
+        DEBUG_ASSERT(index >= 0, "index is less than 0");
+        DEBUG_SCOPE(Type_Size element_size = type_GetSize_Safe(type));
+
+        // the child and its storage can be freed by a writer at any time, so following them needs the read locks
+        DEBUG_SCOPE(vec_LockRead(p_vec));
+        int vec_index = _vec_FindVecWithTypeFromIndex(p_vec, type, 0);
+        bool found = false;
+        if (vec_index != -1) {
+            Vec* p_child = (Vec*)p_vec->p_data + vec_index;
+            DEBUG_SCOPE(vec_LockRead(p_child));
+            if ((size_t)index < p_child->count) {
+                memcpy(p_dst, p_child->p_data + (size_t)index * element_size, element_size);
+                found = true;
+            }
+            DEBUG_SCOPE(vec_UnlockRead(p_child));
+        }
+        DEBUG_SCOPE(vec_UnlockRead(p_vec));
+        return found;
+    }
+
+// ================================================================================================================================
+// IsValid
+// ================================================================================================================================
+    bool vec_IsValid_SafeRead(Vec* p_vec) {
+        DEBUG_ASSERT(p_vec, "NULL pointer");
+        if (p_vec->type == null_type) {printf("p_vec->type == 0. %p\n", p_vec); return false;}
+        if (_vec_IsFrozen(p_vec) || _vec_IsCovered(p_vec)) {
+            return p_vec->count <= p_vec->capacity;
+        }
+        // validity checks are mostly done by threads that already read the vec so they must not queue behind waiting writers
+        DEBUG_SCOPE(_vec_LockRead_Barging(p_vec));
+        bool is_valid = true;
+        if (p_vec->count > p_vec->capacity) {printf("p_vec->count > p_vec->capacity. %p\n", p_vec); is_valid = false;}
+        DEBUG_SCOPE(_vec_UnlockRead(p_vec));
+        return is_valid;
+    }    
+    bool vec_IsValid_UnsafeRead(Vec* p_vec) {
+        DEBUG_ASSERT(p_vec, "NULL pointer");
+        if (p_vec->type == null_type) {printf("p_vec->type == 0. %p\n", p_vec); return false;}
+        if (p_vec->count > p_vec->capacity) {printf("p_vec->count > p_vec->capacity. %p\n", p_vec); return false;}
+        return true;
+    }
+    bool vec_IsValidAtIndices_SafeRead(Vec* p_vec, Type type, size_t indices_count, const int* p_indices) {
+        DEBUG_SCOPE(bool is_valid = vec_IsValid_SafeRead(p_vec));
+        if (!is_valid) {
+            DEBUG_ASSERT(vec_IsNull_UnsafeRead(p_vec), "if vec is not valid then it should be null");
+            return false;
+        }
+
+        bool is_null = false;
+        Vec* p_current = p_vec;
+        DEBUG_SCOPE(vec_LockRead(p_current));
+        int i = 0;
+        for (; i < indices_count; ++i) {
+            DEBUG_SCOPE(unsigned char* p_tmp = (unsigned char*)vec_GetElement_UnsafeRead(p_current, p_indices[i], p_current->type));
+            if (p_current->type != vec_type) {
+                if (i < indices_count-1) {
+                    printf("element is not vec type while also not the last depth which is %d\n", i+1);
+                    is_null = true; // came to element which isnt vec type when not finished with p_indices
+                } else if (!_vec_IsLive(p_current, p_indices[i])) {
+                    printf("element is destroyed\n");
+                    is_null = true;
+                } else {
+                    bool tmp_is_null = true;
+                    DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_current->type));
+                    for (int j = 0; j < element_size; ++j) {
+                        if (p_tmp[j] != 0) {
+                            tmp_is_null = false; // as long as one byte is not null then the whole element is not null
+                        }
+                    }
+                    if (tmp_is_null) {
+                        printf("element is null\n");
+                        is_null = true; // has arrived at the last index and its not a vec and its null
+                    } else if (p_current->type != type) {
+                        printf("element is not the given type\n");
+                        is_valid = false; // came to last type and its not the given type
+                    }
+                }
+                break;
+            }
+            DEBUG_SCOPE(bool tmp_is_valid = vec_IsValid_SafeRead((Vec*)p_tmp));
+            if (!tmp_is_valid) {
+                DEBUG_ASSERT(vec_IsNull_UnsafeRead((Vec*)p_tmp), "vec should be null if its not valid");
+                printf("vec at depth %d is invalid\n", i+1);
+                is_null = true;
+                is_valid = false; 
+                break;
+            }
+            p_current = (Vec*)p_tmp;
+            DEBUG_SCOPE(vec_LockRead(p_current));
+        }
+        for (; i > 0; --i) {
+            DEBUG_SCOPE(vec_UnlockRead(p_current));
             p_current = p_current->p_parent;
             DEBUG_ASSERT(p_current, "should not be NULL because this vec should have been used in the previous loop");
         }
@@ -494,22 +1740,30 @@ Type vec_type = 0;
         DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
         va_list args;
         va_start(args, n_args);
-        DEBUG_SCOPE(int* p_indices = alloc(NULL, n_args * sizeof(int)));
+        int p_small_indices[VEC_SMALL_INDICES_COUNT] = {0};
+        int* p_indices = _vec_GetIndices(n_args, p_small_indices);
         for (size_t i = 0; i < n_args; i++) {
             p_indices[i] = va_arg(args, int);
         }
         va_end(args);
         DEBUG_SCOPE(bool return_bool = vec_IsValidAtIndices_SafeRead(p_vec, type, n_args, p_indices));
-        DEBUG_SCOPE(free(p_indices));
+        _vec_FreeIndices(p_indices, p_small_indices);
         return return_bool;
     }
     bool vec_IsValidAtPath_SafeRead(Vec* p_vec,  Type type, const char* path) {
         DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
         size_t indices_count = 0;
-        DEBUG_SCOPE(int* p_indices = vec_Path_ToIndices(path, &indices_count));
+        int p_small_indices[VEC_SMALL_INDICES_COUNT];
+        DEBUG_SCOPE(int* p_indices = _vec_GetPathIndices(path, p_small_indices, &indices_count));
         DEBUG_ASSERT(p_indices, "Failed to get p_indices from path\n");
         DEBUG_SCOPE(bool return_bool = vec_IsValidAtIndices_SafeRead(p_vec, type, indices_count, p_indices));
-        free(p_indices);
+        _vec_FreeIndices(p_indices, p_small_indices);
+        return return_bool;
+    }
+    bool vec_IsValidAtCompiledPath_SafeRead(Vec* p_vec, Type type, const Vec_Path* p_path) {
+        DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_path, "NULL pointer");
+        DEBUG_SCOPE(bool return_bool = vec_IsValidAtIndices_SafeRead(p_vec, type, p_path->indices_count, p_path->p_indices));
         return return_bool;
     }
 
@@ -522,106 +1776,638 @@ Type vec_type = 0;
 // For simplicity and safety, use only one Vec pointer per thread to avoid complex lock management.
 // This also enforce index sequence rules: a positive index moves to a child, a negative index to a parent, and a positive index cannot immediately precede a negative one. 
 // ================================================================================================================================
-    Vec** vec_MoveStart(Vec* p_vec) {
+    // the Vec** handed out is the cursor itself since p_vec is its first member
+    static Vec_Cursor* _vec_GetCursor(Vec** pp_vec) {
+        return (Vec_Cursor*)pp_vec;
+    }
+    static void _vec_Cursor_Push(Vec_Cursor* p_cursor, Vec* p_next) {
+        if (p_cursor->depth < VEC_CURSOR_MAX_DEPTH) {
+            p_cursor->p_stack[p_cursor->depth] = p_cursor->p_vec;
+        }
+        p_cursor->depth++;
+        p_cursor->p_vec = p_next;
+    }
+    static Vec* _vec_Cursor_Pop(Vec_Cursor* p_cursor) {
+        DEBUG_ASSERT(p_cursor->depth > 0, "cannot move above the Vec the cursor started at");
+        p_cursor->depth--;
+        Vec* p_previous = p_cursor->depth < VEC_CURSOR_MAX_DEPTH ? p_cursor->p_stack[p_cursor->depth] : p_cursor->p_vec->p_parent;
+        DEBUG_ASSERT(p_previous == p_cursor->p_vec->p_parent, "cursor stack does not match p_parent");
+        p_cursor->p_vec = p_previous;
+        return p_previous;
+    }
+    Vec** vec_MoveStart(Vec_Cursor* p_cursor, Vec* p_vec) {
+        DEBUG_ASSERT(p_cursor, "p_cursor is NULL");
         DEBUG_SCOPE(DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "vec is invalid"));
         DEBUG_SCOPE(ASSERT(!p_vec->p_parent, "p_vec is not ground Vec because p_parent is not NULL"));
         DEBUG_SCOPE(vec_LockRead(p_vec));
-        DEBUG_SCOPE(Vec** pp_vec = alloc(NULL, sizeof(Vec*)));
-        *pp_vec = p_vec;
-        return pp_vec;
+        p_cursor->p_vec = p_vec;
+        p_cursor->depth = 0;
+        return &p_cursor->p_vec;
+    }
+    Vec** vec_MoveStartUpgradable(Vec_Cursor* p_cursor, Vec* p_vec) {
+        DEBUG_ASSERT(p_cursor, "p_cursor is NULL");
+        DEBUG_SCOPE(DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "vec is invalid"));
+        DEBUG_SCOPE(ASSERT(!p_vec->p_parent, "p_vec is not ground Vec because p_parent is not NULL"));
+        DEBUG_SCOPE(vec_LockUpgradableRead(p_vec));
+        p_cursor->p_vec = p_vec;
+        p_cursor->depth = 0;
+        return &p_cursor->p_vec;
     }
     void vec_MoveEnd(Vec** pp_vec) {
         DEBUG_SCOPE(ASSERT(pp_vec, "pp_vec is NULL"));
         DEBUG_SCOPE(ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid"));
-        Vec* p_current = *pp_vec;
-        DEBUG_SCOPE(vec_UnlockRead(p_current));
-        while (p_current->p_parent) {
-            p_current = p_current->p_parent;
-            DEBUG_SCOPE(ASSERT(vec_IsValid_UnsafeRead(p_current), "p_vec %p | is invlaid"));
+        Vec_Cursor* p_cursor = _vec_GetCursor(pp_vec);
+        DEBUG_SCOPE(vec_UnlockRead(p_cursor->p_vec));
+        while (p_cursor->depth > 0) {
+            Vec* p_current = _vec_Cursor_Pop(p_cursor);
+            DEBUG_SCOPE(ASSERT(vec_IsValid_UnsafeRead(p_current), "p_vec %p | is invlaid", (void*)p_current));
             DEBUG_SCOPE(vec_UnlockRead(p_current));
         }
-        DEBUG_SCOPE(free(pp_vec));
+        DEBUG_ASSERT(!p_cursor->p_vec->p_parent, "cursor did not end at the Vec it started at");
+    }
+    void vec_MoveToIndex(Vec** pp_vec, int index, Type type) {
+        DEBUG_ASSERT(pp_vec, "pp_vec is null\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        Vec* p_vec = *pp_vec;
+        DEBUG_ASSERT(index == -1 || (size_t)index < p_vec->count, "index(%d) is out of bounds(%zu)", index, p_vec->count);
+        if (index == -1) {
+            DEBUG_SCOPE(vec_UnlockRead(p_vec));
+            Vec* p_parent = _vec_Cursor_Pop(_vec_GetCursor(pp_vec));
+            DEBUG_SCOPE(ASSERT(vec_IsValid_UnsafeRead(p_parent), "p_parent is not valid"));
+            DEBUG_SCOPE(ASSERT(type == vec_type, "wrong type. it has to be vec_type when going to p_parent"));
+        } else {
+            DEBUG_SCOPE(ASSERT(p_vec->type == vec_type, "you cannot move Vec to child that is not a Vec"));
+            DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+            Vec* p_next = (Vec*)(p_vec->p_data + (size_t)index * element_size);
+            DEBUG_SCOPE(ASSERT(vec_IsValid_SafeRead(p_next), "p_next is not a valid Vec"));
+            DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_next->type));
+            DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
+            DEBUG_SCOPE(ASSERT(p_next->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
+            DEBUG_SCOPE(vec_LockRead(p_next));
+            _vec_Cursor_Push(_vec_GetCursor(pp_vec), p_next);
+        }
+    }
+    void vec_MoveToIndexUpgradable(Vec** pp_vec, int index, Type type) {
+        DEBUG_ASSERT(pp_vec, "pp_vec is null\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        Vec* p_vec = *pp_vec;
+        DEBUG_ASSERT(0 <= index && (size_t)index < p_vec->count, "index(%d) is out of bounds(%zu). only children can be upgradable read locked", index, p_vec->count);
+        DEBUG_SCOPE(ASSERT(p_vec->type == vec_type, "you cannot move Vec to child that is not a Vec"));
+        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+        Vec* p_next = (Vec*)(p_vec->p_data + (size_t)index * element_size);
+        DEBUG_SCOPE(ASSERT(vec_IsValid_SafeRead(p_next), "p_next is not a valid Vec"));
+        DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_next->type));
+        DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
+        DEBUG_SCOPE(ASSERT(p_next->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
+        DEBUG_SCOPE(vec_LockUpgradableRead(p_next));
+        _vec_Cursor_Push(_vec_GetCursor(pp_vec), p_next);
+    }
+    void vec_MoveToIndices(Vec** pp_vec, size_t indices_count, const int* p_indices) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+
+        for (int i = 0; i < indices_count; ++i) {
+            if (i < indices_count-1) {
+                DEBUG_ASSERT(!(p_indices[i] >= 0 && p_indices[i+1] == -1), "positive number cannot come before -1. at index %d and %d\n", i, i+1);
+            }
+            int index = p_indices[i];
+            DEBUG_ASSERT(index == -1 || (size_t)index < (*pp_vec)->count, "index at index %d is %d and is out of bounds for count %zu\n", i+1, index, (*pp_vec)->count);
+            if (index == -1) {
+                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, vec_type));
+            } else {
+                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, ((Vec*)(*pp_vec)->p_data)->type));
+            }
+        }
+    }
+    void vec_MoveToVaArgs(Vec** pp_vec, size_t n_args, ...) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        va_list args;
+        va_start(args, n_args);
+        int prev_index = -1;
+        for (size_t i = 0; i < n_args; i++) {
+            int index = va_arg(args, int);
+            DEBUG_ASSERT(index == -1 || (size_t)index < (*pp_vec)->count, "index at index %d is %d and is out of bounds for count %zu\n", i+1, index, (*pp_vec)->count);
+            if (prev_index != -1) {
+                DEBUG_ASSERT(!(prev_index >= 0 && index == -1), "positive number cannot come before -1. at index %d and %d\n", i-1, i);
+            }
+            prev_index = index;
+            if (index == -1) {
+                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, vec_type));
+            } else {
+                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, ((Vec*)(*pp_vec)->p_data)->type));
+            }
+        }
+        va_end(args);
+    }
+    void vec_MoveToAtPath(Vec** pp_vec, const char* path) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        size_t indices_count = 0;
+        int p_small_indices[VEC_SMALL_INDICES_COUNT];
+        DEBUG_SCOPE(int* p_indices = _vec_GetPathIndices(path, p_small_indices, &indices_count));
+        DEBUG_ASSERT(p_indices, "p_indices is NULL pointer\n");
+        DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count, p_indices));
+        _vec_FreeIndices(p_indices, p_small_indices);
+    }
+    void* vec_MoveToPathAndGetElement(Vec** pp_vec, const char* path, Type type) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        size_t indices_count = 0;
+        int p_small_indices[VEC_SMALL_INDICES_COUNT];
+        DEBUG_SCOPE(int* p_indices = _vec_GetPathIndices(path, p_small_indices, &indices_count));
+        DEBUG_ASSERT(p_indices, "p_indices is NULL pointer\n");
+        DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count-1, p_indices));
+        void* p_element = vec_GetElement_UnsafeRead(*pp_vec, p_indices[indices_count-1], type);
+        _vec_FreeIndices(p_indices, p_small_indices);
+        return p_element;
+    }
+    static Vec_PathCacheEntry* _vec_PathCache_GetEntry(Vec_PathCache* p_cache, Vec* p_vec, unsigned int path_id, unsigned int indices_count) {
+        unsigned int hash = (p_vec->id * 0x9E3779B1u) ^ (path_id * 0x85EBCA77u) ^ indices_count;
+        return &p_cache->p_entries[(hash >> 16) % VEC_PATH_CACHE_SIZE];
+    }
+    // locks the Vecs the entry remembers one after the other. the Vec locked last keeps the next one where it is, so
+    // checking the generation of the start right before every lock is enough to know the next one is still there
+    static bool _vec_PathCache_MoveTo(Vec** pp_vec, Vec_PathCacheEntry* p_entry, unsigned int path_id, unsigned int indices_count) {
+        Vec* p_vec = *pp_vec;
+        if (p_entry->p_vec != p_vec || p_entry->vec_id != p_vec->id || p_entry->path_id != path_id || p_entry->indices_count != indices_count) {
+            return false;
+        }
+        Vec_Cursor* p_cursor = _vec_GetCursor(pp_vec);
+        for (unsigned int i = 0; i < indices_count; ++i) {
+            if (SDL_GetAtomicInt(&p_vec->generation) != p_entry->generation) {
+                for (; i > 0; --i) {
+                    vec_UnlockRead(p_cursor->p_vec);
+                    _vec_Cursor_Pop(p_cursor);
+                }
+                return false;
+            }
+            vec_LockRead(p_entry->p_vecs[i]);
+            _vec_Cursor_Push(p_cursor, p_entry->p_vecs[i]);
+        }
+        return true;
+    }
+    static void _vec_MoveToIndicesCached(Vec** pp_vec, unsigned int path_id, unsigned int indices_count, const int* p_indices, Vec_PathCache* p_cache) {
+        Vec_Cursor* p_cursor = _vec_GetCursor(pp_vec);
+        // the Vecs on the way are taken from the cursor stack, so all of them have to fit in it
+        bool cacheable = p_cache && indices_count > 0 && p_cursor->depth + indices_count <= VEC_CURSOR_MAX_DEPTH;
+        for (unsigned int i = 0; cacheable && i < indices_count; ++i) {
+            cacheable = p_indices[i] >= 0;
+        }
+        if (!cacheable) {
+            DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count, p_indices));
+            return;
+        }
+        Vec* p_vec = *pp_vec;
+        Vec_PathCacheEntry* p_entry = _vec_PathCache_GetEntry(p_cache, p_vec, path_id, indices_count);
+        if (_vec_PathCache_MoveTo(pp_vec, p_entry, path_id, indices_count)) {
+            return;
+        }
+        DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count, p_indices));
+        // every Vec on the way is still locked, so none of them can change before the generation is bumped again
+        p_entry->p_vec = p_vec;
+        p_entry->vec_id = p_vec->id;
+        p_entry->path_id = path_id;
+        p_entry->indices_count = indices_count;
+        p_entry->generation = SDL_GetAtomicInt(&p_vec->generation);
+        unsigned int start_depth = p_cursor->depth - indices_count;
+        for (unsigned int i = 0; i + 1 < indices_count; ++i) {
+            p_entry->p_vecs[i] = p_cursor->p_stack[start_depth + 1 + i];
+        }
+        p_entry->p_vecs[indices_count - 1] = p_cursor->p_vec;
+    }
+    void vec_MoveToCompiledPath(Vec** pp_vec, const Vec_Path* p_path, Vec_PathCache* p_cache) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        DEBUG_ASSERT(p_path, "NULL pointer");
+        DEBUG_SCOPE(_vec_MoveToIndicesCached(pp_vec, p_path->id, p_path->indices_count, p_path->p_indices, p_cache));
+    }
+    void* vec_MoveToCompiledPathAndGetElement(Vec** pp_vec, const Vec_Path* p_path, Type type, Vec_PathCache* p_cache) {
+        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+        DEBUG_ASSERT(p_path && p_path->indices_count > 0, "p_path has to lead to an element");
+        unsigned int indices_count = p_path->indices_count;
+        DEBUG_SCOPE(_vec_MoveToIndicesCached(pp_vec, p_path->id, indices_count - 1, p_path->p_indices, p_cache));
+        void* p_element = vec_GetElement_UnsafeRead(*pp_vec, p_path->p_indices[indices_count - 1], type);
+        return p_element;
+    }
+
+// ================================================================================================================================
+// Transactions
+// ================================================================================================================================
+    typedef struct Vec_TransactionEntry {
+        int*                p_indices;
+        size_t              indices_count;
+        Vec_TransactionMode mode;
+        // entries added by type are a direct child of the root whose index is only looked up once the root is locked
+        bool                is_typed;
+        Type                type;
+        Vec*                p_vec;
+    } Vec_TransactionEntry;
+
+    // one Vec to lock. every prefix of every entry path becomes a node so parents are always locked before children
+    typedef struct Vec_TransactionNode {
+        const int*          p_indices;
+        size_t              indices_count;
+        Vec_TransactionMode mode;
+    } Vec_TransactionNode;
+
+    struct Vec_Transaction {
+        Vec*                    p_root;
+        Vec_TransactionEntry*   p_entries;
+        size_t                  entries_count;
+        // every Vec locked by vec_Transaction_Lock in locking order, so they can be unlocked in reverse
+        Vec**                   pp_locked;
+        Vec_TransactionMode*    p_locked_modes;
+        size_t                  locked_count;
+        // written Vecs below another written Vec. they are not locked, but their sequence is odd while locked like that
+        // of every written Vec, so snapshots see that they changed
+        Vec**                   pp_sequenced;
+        size_t                  sequenced_count;
+        bool                    is_locked;
+    };
+
+    Vec_Transaction* vec_Transaction_Create(Vec* p_root) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_root), "p_root is invalid");
+        DEBUG_SCOPE(Vec_Transaction* p_transaction = alloc(NULL, sizeof(Vec_Transaction)));
+        memset(p_transaction, 0, sizeof(Vec_Transaction));
+        p_transaction->p_root = p_root;
+        return p_transaction;
+    }
+    void vec_Transaction_Destroy(Vec_Transaction* p_transaction) {
+        DEBUG_ASSERT(p_transaction, "NULL pointer");
+        DEBUG_ASSERT(!p_transaction->is_locked, "transaction has to be unlocked before it is destroyed");
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            free(p_transaction->p_entries[i].p_indices);
+        }
+        free(p_transaction->p_entries);
+        free(p_transaction->pp_locked);
+        free(p_transaction->p_locked_modes);
+        free(p_transaction->pp_sequenced);
+        free(p_transaction);
+    }
+    int vec_Transaction_AddIndices(Vec_Transaction* p_transaction, Vec_TransactionMode mode, size_t indices_count, const int* p_indices) {
+        DEBUG_ASSERT(p_transaction, "NULL pointer");
+        DEBUG_ASSERT(!p_transaction->is_locked, "entries cannot be added while the transaction is locked");
+        DEBUG_ASSERT(mode <= VEC_TRANSACTION_WRITE, "mode = %d is not a valid transaction mode", mode);
+        DEBUG_ASSERT(indices_count == 0 || p_indices, "NULL pointer");
+        size_t entry = p_transaction->entries_count;
+        DEBUG_SCOPE(p_transaction->p_entries = alloc(p_transaction->p_entries, (entry + 1) * sizeof(Vec_TransactionEntry)));
+        Vec_TransactionEntry* p_entry = &p_transaction->p_entries[entry];
+        // alloc of 0 bytes may give NULL, so there is always room for one index
+        DEBUG_SCOPE(p_entry->p_indices = alloc(NULL, (indices_count + 1) * sizeof(int)));
+        for (size_t i = 0; i < indices_count; ++i) {
+            DEBUG_ASSERT(p_indices[i] >= 0, "index %d at depth %zu is negative. transaction paths can only go down", p_indices[i], i + 1);
+            p_entry->p_indices[i] = p_indices[i];
+        }
+        p_entry->indices_count = indices_count;
+        p_entry->mode = mode;
+        p_entry->is_typed = false;
+        p_entry->type = 0;
+        p_entry->p_vec = NULL;
+        p_transaction->entries_count = entry + 1;
+        return (int)entry;
+    }
+    int vec_Transaction_AddVecWithType(Vec_Transaction* p_transaction, Vec_TransactionMode mode, Type type) {
+        DEBUG_ASSERT(type_IsValid_Safe(type), "type is invalid");
+        DEBUG_SCOPE(int entry = vec_Transaction_AddIndices(p_transaction, mode, 0, NULL));
+        p_transaction->p_entries[entry].is_typed = true;
+        p_transaction->p_entries[entry].type = type;
+        return entry;
+    }
+    int vec_Transaction_AddVaArgs(Vec_Transaction* p_transaction, Vec_TransactionMode mode, size_t n_args, ...) {
+        va_list args;
+        va_start(args, n_args);
+        int p_small_indices[VEC_SMALL_INDICES_COUNT] = {0};
+        int* p_indices = _vec_GetIndices(n_args, p_small_indices);
+        for (size_t i = 0; i < n_args; i++) {
+            p_indices[i] = va_arg(args, int);
+        }
+        va_end(args);
+        DEBUG_SCOPE(int entry = vec_Transaction_AddIndices(p_transaction, mode, n_args, p_indices));
+        _vec_FreeIndices(p_indices, p_small_indices);
+        return entry;
+    }
+    int vec_Transaction_AddPath(Vec_Transaction* p_transaction, Vec_TransactionMode mode, const char* path) {
+        size_t indices_count = 0;
+        int p_small_indices[VEC_SMALL_INDICES_COUNT];
+        DEBUG_SCOPE(int* p_indices = _vec_GetPathIndices(path, p_small_indices, &indices_count));
+        DEBUG_ASSERT(p_indices, "Failed to get p_indices from path\n");
+        DEBUG_SCOPE(int entry = vec_Transaction_AddIndices(p_transaction, mode, indices_count, p_indices));
+        _vec_FreeIndices(p_indices, p_small_indices);
+        return entry;
+    }
+    // parents before children and lower indices before higher, which is the order every locker in this file uses
+    static int _vec_Transaction_CompareNodes(const void* p_a, const void* p_b) {
+        const Vec_TransactionNode* p_node_a = (const Vec_TransactionNode*)p_a;
+        const Vec_TransactionNode* p_node_b = (const Vec_TransactionNode*)p_b;
+        size_t common = p_node_a->indices_count < p_node_b->indices_count ? p_node_a->indices_count : p_node_b->indices_count;
+        for (size_t i = 0; i < common; ++i) {
+            if (p_node_a->p_indices[i] != p_node_b->p_indices[i]) {
+                return p_node_a->p_indices[i] < p_node_b->p_indices[i] ? -1 : 1;
+            }
+        }
+        return (p_node_a->indices_count > p_node_b->indices_count) - (p_node_a->indices_count < p_node_b->indices_count);
+    }
+    void vec_Transaction_Lock(Vec_Transaction* p_transaction) {
+        DEBUG_ASSERT(p_transaction, "NULL pointer");
+        DEBUG_ASSERT(!p_transaction->is_locked, "transaction is already locked");
+
+        // the root comes first in the locking order anyway, and it has to be locked before the entries added by type
+        // can be looked up. they are looked up under this very lock so their index cannot go stale before it is used
+        Vec* p_root = p_transaction->p_root;
+        Vec_TransactionMode root_mode = VEC_TRANSACTION_READ;
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            Vec_TransactionEntry* p_entry = &p_transaction->p_entries[i];
+            if (!p_entry->is_typed && p_entry->indices_count == 0 && p_entry->mode == VEC_TRANSACTION_WRITE) {
+                root_mode = VEC_TRANSACTION_WRITE;
+            }
+        }
+        if (root_mode == VEC_TRANSACTION_WRITE) {
+            DEBUG_SCOPE(vec_LockWrite(p_root));
+        } else {
+            DEBUG_SCOPE(vec_LockRead(p_root));
+        }
+        size_t nodes_count = 0;
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            Vec_TransactionEntry* p_entry = &p_transaction->p_entries[i];
+            if (p_entry->is_typed) {
+                DEBUG_ASSERT(p_root->type == vec_type, "entries by type need a root with child vecs");
+                // a root without a child of that type leaves the entry with no path and no Vec
+                DEBUG_SCOPE(int index = vec_GetVecWithType_UnsafeRead(p_root, p_entry->type));
+                p_entry->p_indices[0] = index;
+                p_entry->indices_count = index == -1 ? 0 : 1;
+            }
+            nodes_count += p_entry->indices_count;
+        }
+
+        // alloc of 0 bytes may give NULL, so there is always room for one node
+        DEBUG_SCOPE(Vec_TransactionNode* p_nodes = alloc(NULL, (nodes_count + 1) * sizeof(Vec_TransactionNode)));
+        nodes_count = 0;
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            Vec_TransactionEntry* p_entry = &p_transaction->p_entries[i];
+            for (size_t depth = 1; depth <= p_entry->indices_count; ++depth) {
+                Vec_TransactionMode mode = depth == p_entry->indices_count ? p_entry->mode : VEC_TRANSACTION_READ;
+                p_nodes[nodes_count++] = (Vec_TransactionNode){p_entry->p_indices, depth, mode};
+            }
+        }
+        qsort(p_nodes, nodes_count, sizeof(Vec_TransactionNode), _vec_Transaction_CompareNodes);
+
+        // a Vec shared by several paths is locked once, written if any of them writes it
+        size_t unique_count = 0;
+        for (size_t i = 0; i < nodes_count; ++i) {
+            if (unique_count > 0 && _vec_Transaction_CompareNodes(&p_nodes[unique_count-1], &p_nodes[i]) == 0) {
+                if (p_nodes[i].mode == VEC_TRANSACTION_WRITE) {
+                    p_nodes[unique_count-1].mode = VEC_TRANSACTION_WRITE;
+                }
+                continue;
+            }
+            p_nodes[unique_count++] = p_nodes[i];
+        }
+
+        DEBUG_SCOPE(p_transaction->pp_locked = alloc(p_transaction->pp_locked, (unique_count + 1) * sizeof(Vec*)));
+        DEBUG_SCOPE(p_transaction->p_locked_modes = alloc(p_transaction->p_locked_modes, (unique_count + 1) * sizeof(Vec_TransactionMode)));
+        DEBUG_SCOPE(p_transaction->pp_sequenced = alloc(p_transaction->pp_sequenced, (unique_count + 1) * sizeof(Vec*)));
+        p_transaction->pp_locked[0] = p_root;
+        p_transaction->p_locked_modes[0] = root_mode;
+        p_transaction->locked_count = 1;
+        p_transaction->sequenced_count = 0;
+
+        // p_ancestors[depth] is the Vec at that depth on the path of the current node. since every prefix is a node
+        // and nodes are sorted, the parent of a node is always the last Vec visited one level up
+        size_t max_depth = 0;
+        for (size_t i = 0; i < unique_count; ++i) {
+            if (p_nodes[i].indices_count > max_depth) {
+                max_depth = p_nodes[i].indices_count;
+            }
+        }
+        DEBUG_SCOPE(Vec** pp_ancestors = alloc(NULL, (max_depth + 1) * sizeof(Vec*)));
+        pp_ancestors[0] = p_root;
+        size_t written_depth = root_mode == VEC_TRANSACTION_WRITE ? 0 : SIZE_MAX;
+        for (size_t i = 0; i < unique_count; ++i) {
+            Vec_TransactionNode* p_node = &p_nodes[i];
+            size_t depth = p_node->indices_count;
+            Vec* p_parent = pp_ancestors[depth-1];
+            DEBUG_ASSERT(p_parent->type == vec_type, "vec at depth %zu has no child vecs", depth - 1);
+            DEBUG_SCOPE(Vec* p_vec = (Vec*)vec_GetElement_UnsafeRead(p_parent, p_node->p_indices[depth-1], vec_type));
+            DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "vec at depth %zu is invalid", depth);
+            pp_ancestors[depth] = p_vec;
+            if (written_depth != SIZE_MAX && depth > written_depth) {
+                // covered Vecs use the sequence of their coarse root, which the write lock above has bumped already
+                if (p_node->mode == VEC_TRANSACTION_WRITE && !_vec_IsCovered(p_vec)) {
+                    SDL_AddAtomicInt(&p_vec->sequence, 1);
+                    p_transaction->pp_sequenced[p_transaction->sequenced_count++] = p_vec;
+                }
+                continue;
+            }
+            written_depth = SIZE_MAX;
+            if (p_node->mode == VEC_TRANSACTION_WRITE) {
+                DEBUG_SCOPE(vec_LockWrite(p_vec));
+                written_depth = depth;
+            } else {
+                DEBUG_SCOPE(vec_LockRead(p_vec));
+            }
+            p_transaction->pp_locked[p_transaction->locked_count] = p_vec;
+            p_transaction->p_locked_modes[p_transaction->locked_count] = p_node->mode;
+            p_transaction->locked_count++;
+        }
+        free(pp_ancestors);
+        free(p_nodes);
+
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            Vec_TransactionEntry* p_entry = &p_transaction->p_entries[i];
+            if (p_entry->is_typed && p_entry->indices_count == 0) {
+                p_entry->p_vec = NULL;
+                continue;
+            }
+            Vec* p_vec = p_root;
+            for (size_t depth = 0; depth < p_entry->indices_count; ++depth) {
+                p_vec = (Vec*)p_vec->p_data + p_entry->p_indices[depth];
+            }
+            p_entry->p_vec = p_vec;
+        }
+        p_transaction->is_locked = true;
+    }
+    void vec_Transaction_Unlock(Vec_Transaction* p_transaction) {
+        DEBUG_ASSERT(p_transaction, "NULL pointer");
+        DEBUG_ASSERT(p_transaction->is_locked, "transaction is not locked");
+        SDL_MemoryBarrierRelease();
+        for (size_t i = 0; i < p_transaction->sequenced_count; ++i) {
+            SDL_AddAtomicInt(&p_transaction->pp_sequenced[i]->sequence, 1);
+        }
+        p_transaction->sequenced_count = 0;
+        for (size_t i = p_transaction->locked_count; i > 0; --i) {
+            if (p_transaction->p_locked_modes[i-1] == VEC_TRANSACTION_WRITE) {
+                DEBUG_SCOPE(vec_UnlockWrite(p_transaction->pp_locked[i-1]));
+            } else {
+                DEBUG_SCOPE(vec_UnlockRead(p_transaction->pp_locked[i-1]));
+            }
+        }
+        p_transaction->locked_count = 0;
+        for (size_t i = 0; i < p_transaction->entries_count; ++i) {
+            p_transaction->p_entries[i].p_vec = NULL;
+        }
+        p_transaction->is_locked = false;
+    }
+    Vec* vec_Transaction_GetVec(Vec_Transaction* p_transaction, int entry) {
+        DEBUG_ASSERT(p_transaction, "NULL pointer");
+        DEBUG_ASSERT(p_transaction->is_locked, "vecs of a transaction can only be used while it is locked");
+        DEBUG_ASSERT(0 <= entry && (size_t)entry < p_transaction->entries_count, "entry(%d) is out of bounds(%zu)", entry, p_transaction->entries_count);
+        return p_transaction->p_entries[entry].p_vec;
+    }
+
+// ================================================================================================================================
+// Snapshots
+//
+// A snapshot Vec keeps the id and sequence of the live Vec it was copied from, which is all it takes to tell whether a
+// leaf of the next snapshot can reuse its data. Leaf data starts with a reference count since it can be shared by
+// any number of snapshots. Child Vecs are never shared, so their p_parent always points into the same snapshot.
+// ================================================================================================================================
+    typedef union Vec_SnapshotData {
+        SDL_AtomicInt   references;
+        max_align_t     alignment;
+    } Vec_SnapshotData;
+
+    struct Vec_Snapshot {
+        SDL_AtomicInt   references;
+        unsigned int    version;
+        Vec*            p_vec;
+    };
+
+    // every Vec of the subtree stays read locked until the whole copy is done, parents before children
+    static void _vec_Snapshot_LockRead(Vec* p_vec) {
+        DEBUG_SCOPE(vec_LockRead(p_vec));
+        if (p_vec->type != vec_type) {
+            return;
+        }
+        for (size_t i = 0; i < p_vec->count; ++i) {
+            Vec* p_child = (Vec*)p_vec->p_data + i;
+            if (p_child->type != null_type) {
+                DEBUG_SCOPE(_vec_Snapshot_LockRead(p_child));
+            }
+        }
     }
-    void vec_MoveToIndex(Vec** pp_vec, int index, Type type) {
-        DEBUG_ASSERT(pp_vec, "pp_vec is null\n");
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
-        Vec* p_vec = *pp_vec;
-        DEBUG_ASSERT(-1 <= index && index < (int)p_vec->count, "index(%d) is out of bounds(%d)", index, p_vec->count);
-        if (index == -1) {
-            Vec* p_parent = p_vec->p_parent;
-            DEBUG_SCOPE(ASSERT(vec_IsValid_UnsafeRead(p_parent), "p_parent is not valid"));
-            DEBUG_SCOPE(vec_UnlockRead(p_vec));
-            DEBUG_SCOPE(ASSERT(type == vec_type, "wrong type. it has to be vec_type when going to p_parent"));
-            *pp_vec = p_parent;
-        } else {
-            DEBUG_SCOPE(ASSERT(p_vec->type == vec_type, "you cannot move Vec to child that is not a Vec"));
-            DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
-            Vec* p_next = (Vec*)(p_vec->p_data + index * element_size);
-            DEBUG_SCOPE(ASSERT(vec_IsValid_SafeRead(p_next), "p_next is not a valid Vec"));
-            DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_next->type));
-            DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
-            DEBUG_SCOPE(ASSERT(p_next->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
-            DEBUG_SCOPE(vec_LockRead(p_next));
-            *pp_vec = p_next;
+    static void _vec_Snapshot_UnlockRead(Vec* p_vec) {
+        if (p_vec->type == vec_type) {
+            for (size_t i = 0; i < p_vec->count; ++i) {
+                Vec* p_child = (Vec*)p_vec->p_data + i;
+                if (p_child->type != null_type) {
+                    DEBUG_SCOPE(_vec_Snapshot_UnlockRead(p_child));
+                }
+            }
         }
+        DEBUG_SCOPE(vec_UnlockRead(p_vec));
     }
-    void vec_MoveToIndices(Vec** pp_vec, size_t indices_count, const int* p_indices) {
-        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
+    static void _vec_Snapshot_Copy(Vec* p_dst, Vec* p_source, Vec* p_previous, Vec* p_parent) {
+        DEBUG_ASSERT(!(p_source->flags & VEC_FLAG_COLUMNAR), "p_source = %p | columnar vecs cannot be snapshot", p_source);
+        memset(p_dst, 0, sizeof(Vec));
+        p_dst->type = p_source->type;
+        p_dst->flags = VEC_FLAG_FROZEN;
+        p_dst->p_parent = p_parent;
+        p_dst->count = p_source->count;
+        p_dst->capacity = p_source->count;
+        p_dst->id = p_source->id;
+        unsigned int sequence = (unsigned int)SDL_GetAtomicInt(&_vec_GetCoarseRoot(p_source)->sequence);
+        SDL_SetAtomicInt(&p_dst->sequence, (int)sequence);
+        if (p_source->count == 0) {
+            return;
+        }
+        if (p_previous && (p_previous->type != p_source->type || p_previous->id != p_source->id)) {
+            p_previous = NULL;
+        }
 
-        for (int i = 0; i < indices_count; ++i) {
-            if (i < indices_count-1) {
-                DEBUG_ASSERT(!(p_indices[i] >= 0 && p_indices[i+1] == -1), "positive number cannot come before -1. at index %d and %d\n", i, i+1);
-            }
-            int index = p_indices[i];
-            DEBUG_ASSERT(-1 <= index && index < (int)(*pp_vec)->count, "index at index %d is %d and is out of bounds for count %d\n", i+1, index, (*pp_vec)->count);
-            if (index == -1) {
-                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, vec_type));
-            } else {
-                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, ((Vec*)(*pp_vec)->p_data)->type));
+        if (p_source->type == vec_type) {
+            DEBUG_SCOPE(p_dst->p_data = alloc_Aligned(NULL, 0, p_source->count * sizeof(Vec), VEC_CACHE_LINE_SIZE));
+            for (size_t i = 0; i < p_source->count; ++i) {
+                Vec* p_child = (Vec*)p_source->p_data + i;
+                Vec* p_child_dst = (Vec*)p_dst->p_data + i;
+                if (p_child->type == null_type) {
+                    memset(p_child_dst, 0, sizeof(Vec));
+                    continue;
+                }
+                Vec* p_child_previous = p_previous && i < p_previous->count ? (Vec*)p_previous->p_data + i : NULL;
+                DEBUG_SCOPE(_vec_Snapshot_Copy(p_child_dst, p_child, p_child_previous, p_dst));
             }
+            return;
+        }
+
+        if (p_previous && (unsigned int)SDL_GetAtomicInt(&p_previous->sequence) == sequence && p_previous->p_data) {
+            Vec_SnapshotData* p_data = (Vec_SnapshotData*)p_previous->p_data - 1;
+            SDL_AddAtomicInt(&p_data->references, 1);
+            p_dst->p_data = p_previous->p_data;
+            return;
         }
+        DEBUG_SCOPE(size_t size = p_source->count * type_GetSize_Safe(p_source->type));
+        DEBUG_SCOPE(Vec_SnapshotData* p_data = alloc(NULL, sizeof(Vec_SnapshotData) + size));
+        SDL_SetAtomicInt(&p_data->references, 1);
+        p_dst->p_data = (unsigned char*)(p_data + 1);
+        memcpy(p_dst->p_data, p_source->p_data, size);
     }
-    void vec_MoveToVaArgs(Vec** pp_vec, size_t n_args, ...) {
-        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
-        va_list args;
-        va_start(args, n_args);
-        int prev_index = -1;
-        for (size_t i = 0; i < n_args; i++) {
-            int index = va_arg(args, int);
-            DEBUG_ASSERT(-1 <= index && index < (int)(*pp_vec)->count, "index at index %d is %d and is out of bounds for count %d\n", i+1, index, (*pp_vec)->count);
-            if (prev_index != -1) {
-                DEBUG_ASSERT(!(prev_index >= 0 && index == -1), "positive number cannot come before -1. at index %d and %d\n", i-1, i);
+    static void _vec_Snapshot_Free(Vec* p_vec) {
+        if (!p_vec->p_data) {
+            return;
+        }
+        if (p_vec->type == vec_type) {
+            for (size_t i = 0; i < p_vec->count; ++i) {
+                Vec* p_child = (Vec*)p_vec->p_data + i;
+                if (p_child->type != null_type) {
+                    DEBUG_SCOPE(_vec_Snapshot_Free(p_child));
+                }
             }
-            prev_index = index;
-            if (index == -1) {
-                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, vec_type));
-            } else {
-                DEBUG_SCOPE(vec_MoveToIndex(pp_vec, index, ((Vec*)(*pp_vec)->p_data)->type));
+            DEBUG_SCOPE(free(p_vec->p_data));
+            return;
+        }
+        Vec_SnapshotData* p_data = (Vec_SnapshotData*)p_vec->p_data - 1;
+        if (SDL_AddAtomicInt(&p_data->references, -1) == 1) {
+            DEBUG_SCOPE(free(p_data));
+        }
+    }
+    Vec_Snapshot* vec_Snapshot(Vec* p_vec, Vec_Snapshot* p_previous) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid");
+        if (p_previous && p_vec->type != vec_type) {
+            // a leaf whose sequence did not move is exactly the previous snapshot, so that is handed out again
+            Vec* p_previous_vec = p_previous->p_vec;
+            DEBUG_SCOPE(_vec_Snapshot_LockRead(p_vec));
+            bool unchanged = p_previous_vec->type == p_vec->type && p_previous_vec->id == p_vec->id &&
+                SDL_GetAtomicInt(&p_previous_vec->sequence) == SDL_GetAtomicInt(&_vec_GetCoarseRoot(p_vec)->sequence);
+            DEBUG_SCOPE(_vec_Snapshot_UnlockRead(p_vec));
+            if (unchanged) {
+                DEBUG_SCOPE(vec_Snapshot_Retain(p_previous));
+                return p_previous;
             }
         }
-        va_end(args);
+        DEBUG_SCOPE(Vec_Snapshot* p_snapshot = alloc(NULL, sizeof(Vec_Snapshot)));
+        SDL_SetAtomicInt(&p_snapshot->references, 1);
+        p_snapshot->version = p_previous ? p_previous->version + 1 : 0;
+        DEBUG_SCOPE(p_snapshot->p_vec = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE));
+
+        DEBUG_SCOPE(_vec_Snapshot_LockRead(p_vec));
+        DEBUG_SCOPE(_vec_Snapshot_Copy(p_snapshot->p_vec, p_vec, p_previous ? p_previous->p_vec : NULL, NULL));
+        DEBUG_SCOPE(_vec_Snapshot_UnlockRead(p_vec));
+        return p_snapshot;
     }
-    void vec_MoveToAtPath(Vec** pp_vec, const char* path) {
-        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
-        size_t indices_count = 0;
-        DEBUG_SCOPE(int* p_indices = vec_Path_ToIndices(path, &indices_count));
-        DEBUG_ASSERT(p_indices, "p_indices is NULL pointer\n");
-        DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count, p_indices));
-        free(p_indices);
+    void vec_Snapshot_Retain(Vec_Snapshot* p_snapshot) {
+        DEBUG_ASSERT(p_snapshot, "NULL pointer");
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_snapshot->references) > 0, "snapshot is already freed");
+        SDL_AddAtomicInt(&p_snapshot->references, 1);
     }
-    void* vec_MoveToPathAndGetElement(Vec** pp_vec, const char* path, Type type) {
-        DEBUG_ASSERT(pp_vec, "p_vec is NULL pointer\n");
-        DEBUG_ASSERT(vec_IsValid_UnsafeRead(*pp_vec), "*pp_vec is invalid\n");
-        size_t indices_count = 0;
-        DEBUG_SCOPE(int* p_indices = vec_Path_ToIndices(path, &indices_count));
-        DEBUG_ASSERT(p_indices, "p_indices is NULL pointer\n");
-        DEBUG_SCOPE(vec_MoveToIndices(pp_vec, indices_count-1, p_indices));
-        void* p_element = vec_GetElement_UnsafeRead(*pp_vec, p_indices[indices_count-1], type);
-        free(p_indices);
-        return p_element;
+    void vec_Snapshot_Release(Vec_Snapshot* p_snapshot) {
+        DEBUG_ASSERT(p_snapshot, "NULL pointer");
+        DEBUG_ASSERT(SDL_GetAtomicInt(&p_snapshot->references) > 0, "snapshot is already freed");
+        if (SDL_AddAtomicInt(&p_snapshot->references, -1) != 1) {
+            return;
+        }
+        DEBUG_SCOPE(_vec_Snapshot_Free(p_snapshot->p_vec));
+        DEBUG_SCOPE(free(p_snapshot->p_vec));
+        DEBUG_SCOPE(free(p_snapshot));
+    }
+    Vec* vec_Snapshot_GetVec(Vec_Snapshot* p_snapshot) {
+        DEBUG_ASSERT(p_snapshot, "NULL pointer");
+        return p_snapshot->p_vec;
+    }
+    unsigned int vec_Snapshot_GetVersion(Vec_Snapshot* p_snapshot) {
+        DEBUG_ASSERT(p_snapshot, "NULL pointer");
+        return p_snapshot->version;
     }
 
 // ================================================================================================================================
@@ -633,20 +2419,8 @@ Type vec_type = 0;
         DEBUG_ASSERT(type_IsValid_Safe(type), "type is invalid");
         DEBUG_ASSERT(index >= 0, "index is less than 0");
 
-        DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(p_vec));
-        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
-        int type_index = -1;
-        for (unsigned int i = index; i < count; ++i) {
-            Vec* element = (Vec*)(p_vec->p_data + i * element_size);
-            DEBUG_SCOPE(vec_LockRead(element));
-            if (element->type == type) {
-                type_index = i;
-                DEBUG_SCOPE(vec_UnlockRead(element));
-                break; 
-            }
-            DEBUG_SCOPE(vec_UnlockRead(element));
-        }
-        return type_index;
+        // the type of a child only changes while this Vec is write locked, so the children are not locked
+        return _vec_FindVecWithTypeFromIndex(p_vec, type, index);
     }
     int vec_GetVecWithType_UnsafeRead(Vec* p_vec, Type type) {
         DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid");
@@ -666,11 +2440,30 @@ Type vec_type = 0;
         DEBUG_SCOPE(int type_index = vec_GetVecWithTypeFromIndex_UnafeRead(p_vec, type, index));
 
         if (type_index == -1) {
-            DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(p_vec));
-            DEBUG_SCOPE(vec_SetCount_UnsafeWrite(p_vec, count + 1));
-            DEBUG_SCOPE(Vec* new_element = (Vec*)((char*)p_vec->p_data + count * type_GetSize_Safe(p_vec->type)));
-            DEBUG_SCOPE(vec_Initialize(new_element, p_vec, type));
-            return count;
+            DEBUG_SCOPE(type_index = vec_AppendVecWithType_UnsafeWrite(p_vec, type));
+        }
+        return type_index;
+    }
+    int vec_AppendVecWithType_UnsafeWrite(Vec* p_vec, Type type) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid");
+        DEBUG_ASSERT(p_vec->type == vec_type, "type of provided vec has to be vec_type");
+        DEBUG_ASSERT(type_IsValid_Safe(type), "type is invalid");
+        DEBUG_SCOPE(size_t count = vec_GetCount_UnsafeRead(p_vec));
+        DEBUG_SCOPE(vec_SetCount_UnsafeWrite(p_vec, count + 1));
+        DEBUG_ASSERT(count < INT_MAX, "p_vec = %p | count %zu does not fit the int index", p_vec, count);
+        DEBUG_SCOPE(Vec* new_element = (Vec*)((char*)p_vec->p_data + count * type_GetSize_Safe(p_vec->type)));
+        DEBUG_SCOPE(vec_Initialize(new_element, p_vec, type));
+        return (int)count;
+    }
+    int vec_UpsertVecWithType_UpgradableRead(Vec* p_vec, Type type) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "vec is invalid");
+        DEBUG_ASSERT(vec_IsUpgradableReadLocked(p_vec), "vec has to be upgradable read locked");
+        DEBUG_SCOPE(int type_index = vec_GetVecWithType_UnsafeRead(p_vec, type));
+        if (type_index == -1) {
+            // nobody else can have added it since the lookup because only the upgrader can become a writer
+            DEBUG_SCOPE(vec_UpgradeToWrite(p_vec));
+            DEBUG_SCOPE(type_index = vec_AppendVecWithType_UnsafeWrite(p_vec, type));
+            DEBUG_SCOPE(vec_DowngradeWriteToUpgradable(p_vec));
         }
         return type_index;
     }
@@ -684,42 +2477,185 @@ Type vec_type = 0;
 // ================================================================================================================================
 // UpsertNullElement
 // ================================================================================================================================
-    int vec_UpsertNullElement_UnsafeWrite(Vec* p_vec, Type type) {
+    int vec_FindNullElement_UnsafeRead(Vec* p_vec, Type type) {
         DEBUG_SCOPE(DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "Vec is invalid"));
         DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_vec->type));
         DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
         DEBUG_SCOPE(ASSERT(p_vec->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
 
-        int index = -1;
-        DEBUG_SCOPE(unsigned int count = vec_GetCount_UnsafeRead(p_vec));
-        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
-        for (int i = 0; i < count; ++i) {
-            bool element_is_null = true;
-            DEBUG_SCOPE(unsigned char* element_ptr = vec_GetElement_UnsafeRead(p_vec, i, p_vec->type));
-            for (unsigned int j = 0; j < element_size; ++j) {
-                if (*(element_ptr + j) != 0) {
-                    element_is_null = false;
-                    break;
-                }
-            }
-            if (element_is_null) {
-                index = i;
-                break;
+        if (p_vec->free_count == 0) {
+            return -1;
+        }
+        size_t free_index = p_vec->p_free_indices[p_vec->free_count - 1];
+        DEBUG_ASSERT(free_index <= INT_MAX, "p_vec = %p | destroyed element %zu does not fit the int index", p_vec, free_index);
+        int index = (int)free_index;
+        #ifdef DEBUG
+            DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+            DEBUG_SCOPE(unsigned char* element_ptr = vec_GetElement_UnsafeRead(p_vec, index, p_vec->type));
+            for (unsigned int i = 0; i < element_size; ++i) {
+                ASSERT(element_ptr[i] == 0, "p_vec = %p | destroyed element %d has been written to", p_vec, index);
             }
+        #endif // DEBUG
+        return index;
+    }
+    int vec_AppendNullElement_UnsafeWrite(Vec* p_vec, Type type) {
+        DEBUG_SCOPE(DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "Vec is invalid"));
+        DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_vec->type));
+        DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
+        DEBUG_SCOPE(ASSERT(p_vec->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
+
+        DEBUG_SCOPE(size_t count = vec_GetCount_UnsafeRead(p_vec));
+        DEBUG_ASSERT(count < INT_MAX, "p_vec = %p | count %zu does not fit the int index", p_vec, count);
+        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+        DEBUG_SCOPE(vec_SetCount_UnsafeWrite(p_vec, count + 1));
+        DEBUG_SCOPE(unsigned char* element_ptr = vec_GetElement_UnsafeRead(p_vec, count, p_vec->type));
+        for (unsigned int i = 0; i < element_size; ++i) {
+            ASSERT((*(element_ptr + i) == 0), "newly created element is not null");
         }
+        return (int)count;
+    }
+    int vec_UpsertNullElement_UnsafeWrite(Vec* p_vec, Type type) {
+        DEBUG_SCOPE(int index = vec_FindNullElement_UnsafeRead(p_vec, type));
 
         // if not null element was found then the Vec has to increase in count
         if (index == -1) {
-            DEBUG_SCOPE(vec_SetCount_UnsafeWrite(p_vec, count + 1));
-            DEBUG_SCOPE(unsigned char* element_ptr = vec_GetElement_UnsafeRead(p_vec, count, p_vec->type));
-            for (unsigned int i = 0; i < element_size; ++i) {
-                ASSERT((*(element_ptr + i) == 0), "newly created element is not null");
-            }
-            index = count;
+            DEBUG_SCOPE(index = vec_AppendNullElement_UnsafeWrite(p_vec, type));
+        } else {
+            p_vec->free_count--;
+            _vec_SetOccupancy(p_vec, index, index + 1, true);
         }
 
         return index;
     }
+    void vec_DestroyElement_UnsafeWrite(Vec* p_vec, int index, Type type) {
+        DEBUG_SCOPE(DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "Vec is invalid"));
+        DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_vec->type));
+        DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
+        DEBUG_SCOPE(ASSERT(p_vec->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
+        DEBUG_ASSERT(0 <= index && (size_t)index < p_vec->count, "index(%d) is out of bounds(%zu)", index, p_vec->count);
+        ASSERT(_vec_IsLive(p_vec, index), "p_vec = %p | element %d is already destroyed", p_vec, index);
+
+        DEBUG_SCOPE(unsigned char* element_ptr = vec_GetElement_UnsafeRead(p_vec, index, p_vec->type));
+        DEBUG_SCOPE(Type_Destructor type_destructor = type_GetTypeInfo_Safe(p_vec->type).destructor);
+        if (type_destructor) {
+            DEBUG_SCOPE(type_destructor(element_ptr));
+        }
+        // destructors are expected to zero the element but not all of them do
+        DEBUG_SCOPE(memset(element_ptr, 0, type_GetSize_Safe(p_vec->type)));
+
+        if (!p_vec->p_occupancy) {
+            p_vec->p_occupancy = _vec_Alloc(p_vec, NULL, 0, _vec_GetOccupancySize(p_vec->capacity), sizeof(Uint64));
+            memset(p_vec->p_occupancy, 0, _vec_GetOccupancyWordsCount(p_vec->capacity) * sizeof(Uint64));
+            _vec_SetOccupancy(p_vec, 0, p_vec->count, true);
+        }
+        _vec_SetOccupancy(p_vec, index, index + 1, false);
+        _vec_ReserveFreeIndices(p_vec, p_vec->free_count + 1);
+        p_vec->p_free_indices[p_vec->free_count++] = index;
+    }
+
+// ================================================================================================================================
+// Live elements
+// ================================================================================================================================
+    bool vec_IsElementNull_UnsafeRead(Vec* p_vec, int index) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(0 <= index && (size_t)index < p_vec->count, "index(%d) is out of bounds(%zu)", index, p_vec->count);
+        return !_vec_IsLive(p_vec, index);
+    }
+    size_t vec_GetLiveCount_UnsafeRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        if (!p_vec->p_occupancy) {
+            return p_vec->count;
+        }
+        size_t live_count = 0;
+        size_t words_count = _vec_GetOccupancyWordsCount(p_vec->count);
+        for (size_t i = 0; i < words_count; ++i) {
+            live_count += __builtin_popcountll(p_vec->p_occupancy[i]);
+        }
+        return live_count;
+    }
+    int vec_GetNextLiveIndex_UnsafeRead(Vec* p_vec, int index) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(0 <= index, "index(%d) is negative", index);
+        DEBUG_SCOPE(size_t live_index = _vec_GetNextLiveIndex(p_vec, index));
+        if (live_index == SIZE_MAX) {
+            return -1;
+        }
+        DEBUG_ASSERT(live_index <= INT_MAX, "p_vec = %p | live element %zu does not fit the int index", p_vec, live_index);
+        return (int)live_index;
+    }
+
+// ================================================================================================================================
+// Compaction
+// ================================================================================================================================
+    // moves the live elements of one row of element_size byte elements together. bits past count are always clear
+    static void _vec_CompactElements(Vec* p_vec, unsigned char* p_elements, size_t element_size) {
+        size_t words_count = _vec_GetOccupancyWordsCount(p_vec->count);
+        size_t new_index = 0;
+        for (size_t i = 0; i < words_count; ++i) {
+            Uint64 word = p_vec->p_occupancy[i];
+            while (word) {
+                size_t index = i * 64 + __builtin_ctzll(word);
+                if (index != new_index) {
+                    memcpy(p_elements + new_index * element_size, p_elements + index * element_size, element_size);
+                }
+                new_index++;
+                word &= word - 1;
+            }
+        }
+    }
+    void vec_Compact_UnsafeWrite(Vec* p_vec, Vec_Remap p_remap, void* p_user) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_STABLE), "p_vec = %p | elements of a stable vec never move", p_vec);
+        if (p_vec->p_occupancy) {
+            if (p_vec->flags & VEC_FLAG_COLUMNAR) {
+                unsigned int fields_count;
+                DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+                for (unsigned int i = 0; i < fields_count; ++i) {
+                    _vec_CompactElements(p_vec, p_vec->p_data + _vec_GetColumnOffset(p_fields, i, p_vec->capacity), p_fields[i].size);
+                }
+            } else {
+                DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_vec->type));
+                _vec_CompactElements(p_vec, p_vec->p_data, element_size);
+            }
+            // the bits still describe the old indices until every element has been reported
+            size_t words_count = _vec_GetOccupancyWordsCount(p_vec->count);
+            size_t new_index = 0;
+            size_t first_moved = p_vec->count;
+            for (size_t i = 0; i < words_count; ++i) {
+                Uint64 word = p_vec->p_occupancy[i];
+                while (word) {
+                    size_t index = i * 64 + __builtin_ctzll(word);
+                    if (index != new_index) {
+                        first_moved = first_moved < new_index ? first_moved : new_index;
+                        if (p_remap) {
+                            p_remap(p_user, index, new_index);
+                        }
+                    }
+                    new_index++;
+                    word &= word - 1;
+                }
+            }
+            // every element is live now, which is what no bitmap at all stands for
+            _vec_Free(p_vec, p_vec->p_occupancy, _vec_GetOccupancySize(p_vec->capacity));
+            p_vec->p_occupancy = NULL;
+            _vec_FreeFreeIndices(p_vec);
+            p_vec->count = new_index;
+            if (p_vec->type == vec_type && first_moved < new_index) {
+                _vec_RelinkChildren(p_vec, first_moved, new_index);
+                DEBUG_SCOPE(_vec_TypeIndices_Rebuild(p_vec));
+                _vec_BumpGeneration(p_vec);
+            }
+        }
+    	if (p_vec->capacity != p_vec->count) {
+    		DEBUG_SCOPE(_vec_ReallocData(p_vec, p_vec->count));
+    		p_vec->capacity = p_vec->count;
+    	}
+    }
+    void vec_Compact_SafeWrite(Vec* p_vec, Vec_Remap p_remap, void* p_user) {
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+        DEBUG_SCOPE(vec_Compact_UnsafeWrite(p_vec, p_remap, p_user));
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
 
 // ================================================================================================================================
 // Create Locking
@@ -728,13 +2664,14 @@ Type vec_type = 0;
 // ================================================================================================================================
 // Get
 // ================================================================================================================================
-    unsigned char* vec_GetElement_UnsafeRead(Vec* p_vec, int index, Type type) {
+    unsigned char* vec_GetElement_UnsafeRead(Vec* p_vec, size_t index, Type type) {
         DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
         DEBUG_SCOPE(Type_Info next_type = type_GetTypeInfo_Safe(p_vec->type));
         DEBUG_SCOPE(Type_Info given_type = type_GetTypeInfo_Safe(type));
         DEBUG_SCOPE(ASSERT(p_vec->type == type, "wrong type: %s vs %s\n", next_type.name, given_type.name));
         ASSERT(p_vec->type == type, "wrong type");
-        DEBUG_ASSERT(0 <= index && index < p_vec->count, "index(%d) is out of bounds(%d)", index, p_vec->count);
+        DEBUG_ASSERT(index < p_vec->count, "index(%zu) is out of bounds(%zu)", index, p_vec->count);
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_COLUMNAR), "p_vec = %p | elements of a columnar vec are only stored field by field", p_vec);
         DEBUG_SCOPE(unsigned char* ptr = p_vec->p_data + index * type_GetSize_Safe(p_vec->type));
         return ptr;
     }
@@ -747,270 +2684,395 @@ Type vec_type = 0;
         DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
     	return p_vec->type;
     }
-    unsigned int vec_GetCount_UnsafeRead(Vec* p_vec) {
+    size_t vec_GetCount_UnsafeRead(Vec* p_vec) {
         DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
     	return p_vec->count;
     }
+    size_t vec_GetCapacity_UnsafeRead(Vec* p_vec) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+    	return p_vec->capacity;
+    }
 
 // ================================================================================================================================
 // Set
 // ================================================================================================================================
-    void vec_SetCount_UnsafeWrite(Vec* p_vec, unsigned int count) {
-        printf("setting count\n");
-    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+    static void _vec_ZeroColumns(Vec* p_vec, size_t first, size_t last) {
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        for (unsigned int i = 0; i < fields_count; ++i) {
+            unsigned char* p_column = p_vec->p_data + _vec_GetColumnOffset(p_fields, i, p_vec->capacity);
+            memset(p_column + first * p_fields[i].size, 0, (last - first) * p_fields[i].size);
+        }
+    }
+    static void _vec_SetCount(Vec* p_vec, size_t count, bool zero) {
     	if (p_vec->count < count) {
             DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
-    		if (count > p_vec->capacity) {
-    			unsigned int new_capacity = 1;
-    			while (count >= new_capacity) {
-    				new_capacity*=2;
-    			}
-    			DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, new_capacity * element_size));
-    			p_vec->capacity = new_capacity;
-    		}
-    		memset((unsigned char*)(p_vec->p_data) + p_vec->count * element_size, 0, (count - p_vec->count) * element_size);
-    	}
+            DEBUG_SCOPE(_vec_Reserve(p_vec, count));
+            if (zero && (p_vec->flags & VEC_FLAG_COLUMNAR)) {
+                DEBUG_SCOPE(_vec_ZeroColumns(p_vec, p_vec->count, count));
+            } else if (zero) {
+    		    memset((unsigned char*)(p_vec->p_data) + p_vec->count * element_size, 0, (count - p_vec->count) * element_size);
+            }
+            _vec_SetOccupancy(p_vec, p_vec->count, count, true);
+    	} else {
+            if (count < p_vec->count && p_vec->type == vec_type) {
+                _vec_BumpGeneration(p_vec);
+            }
+            _vec_SetOccupancy(p_vec, count, p_vec->count, false);
+            // destroyed elements past the new end are gone and must not be handed out again
+            size_t kept = 0;
+            size_t* p_free_indices = p_vec->p_free_indices;
+            for (size_t i = 0; i < p_vec->free_count; ++i) {
+                if (p_free_indices[i] < count) {
+                    p_free_indices[kept++] = p_free_indices[i];
+                }
+            }
+            p_vec->free_count = kept;
+        }
     	p_vec->count = count;
     }
-    void vec_SetCapacity_UnsafeWrite(Vec* p_vec, unsigned int capacity) {
+    void vec_SetCount_UnsafeWrite(Vec* p_vec, size_t count) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_SCOPE(_vec_SetCount(p_vec, count, true));
+    }
+    void vec_SetCapacity_UnsafeWrite(Vec* p_vec, size_t capacity) {
     	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
         DEBUG_ASSERT(capacity >= p_vec->count, "capacity cannot be less than p_vec->count");
     	if (p_vec->capacity != capacity) {
-    		DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, capacity*type_GetSize_Safe(p_vec->type)));
+    		DEBUG_SCOPE(_vec_ReallocData(p_vec, capacity));
+    		p_vec->capacity = capacity;
+    	}
+    }
+
+// ================================================================================================================================
+// Growth
+// ================================================================================================================================
+    void vec_SetGrowthPolicy_UnsafeWrite(Vec* p_vec, unsigned int growth_percent, unsigned int min_chunk) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        ASSERT(growth_percent == 0 || (growth_percent > 100 && growth_percent <= USHRT_MAX), "growth_percent = %u has to be above 100, or 0 for the default", growth_percent);
+        p_vec->growth_percent = (unsigned short)growth_percent;
+        p_vec->growth_chunk = min_chunk;
+    }
+    void vec_SetMapFlags_UnsafeWrite(Vec* p_vec, unsigned int map_flags) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        ASSERT(!(map_flags & ~(VEC_MAP_HUGE_PAGES | VEC_MAP_PREFAULT)), "map_flags = %02x has unknown flags", map_flags);
+        p_vec->map_flags = (unsigned char)map_flags;
+#ifdef __linux__
+        // storage that is mapped already follows the flags from now on, a stable one only up to its count
+        if (map_flags && (p_vec->flags & VEC_FLAG_MAPPED)) {
+            DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_vec->type));
+            size_t size = p_vec->capacity * element_size;
+            size_t prefault_size = p_vec->flags & VEC_FLAG_STABLE ? p_vec->count * element_size : size;
+            _vec_AdviseMapped(p_vec, p_vec->p_data, size, 0, prefault_size);
+        }
+#endif
+    }
+    void vec_Reserve_UnsafeWrite(Vec* p_vec, size_t capacity) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        // exactly what was asked for, since the caller knows how much is coming
+    	if (capacity > p_vec->capacity) {
+    		DEBUG_SCOPE(_vec_ReallocData(p_vec, capacity));
     		p_vec->capacity = capacity;
     	}
     }
+    void vec_ShrinkToFit_UnsafeWrite(Vec* p_vec) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        // destroyed elements at the end hold no data so they are dropped first
+        size_t count = p_vec->count;
+        while (count > 0 && !_vec_IsLive(p_vec, count - 1)) {
+            count--;
+        }
+        if (count < p_vec->count) {
+            DEBUG_SCOPE(_vec_SetCount(p_vec, count, true));
+        }
+        if (p_vec->flags & VEC_FLAG_STABLE) {
+#ifdef __linux__
+            // the pages stay reserved and read as zero again once they are touched
+            DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_vec->type));
+            size_t used_size = _vec_GetMappedSize(count * element_size);
+            size_t size = _vec_GetMappedSize(p_vec->capacity * element_size);
+            if (used_size < size) {
+                madvise(p_vec->p_data + used_size, size - used_size, MADV_DONTNEED);
+            }
+#endif
+            return;
+        }
+    	if (p_vec->capacity != count) {
+    		DEBUG_SCOPE(_vec_ReallocData(p_vec, count));
+    		p_vec->capacity = count;
+    	}
+    }
+    void vec_SetStableAddresses_UnsafeWrite(Vec* p_vec, size_t max_capacity) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_STABLE), "p_vec = %p | already has stable addresses", p_vec);
+        DEBUG_ASSERT(max_capacity >= p_vec->count, "max_capacity cannot be less than p_vec->count");
+        DEBUG_ASSERT(!p_vec->p_arena, "p_vec = %p | storage of an arena tree cannot be reserved on its own", p_vec);
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_COLUMNAR), "p_vec = %p | columns move apart whenever the capacity changes", p_vec);
+        DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_vec->type));
+        size_t size = max_capacity * element_size;
+        unsigned char* p_old_data = p_vec->p_data;
+        unsigned char* p_data = NULL;
+#ifdef __linux__
+        void* p_map;
+        if (p_vec->map_flags & VEC_MAP_HUGE_PAGES) {
+            p_map = _vec_MapHugeAligned(size, MAP_NORESERVE);
+        } else {
+            p_map = mmap(NULL, _vec_GetMappedSize(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        }
+        ASSERT(p_map != MAP_FAILED, "p_vec = %p | failed to reserve %zu bytes", p_vec, size);
+        p_data = p_map;
+        // faulting in the whole reservation would defeat it, so only the huge pages advice applies
+        _vec_AdviseMapped(p_vec, p_data, size, 0, 0);
+#else
+        // large allocations are only backed by memory once written on most systems as well
+        p_data = _vec_Alloc(p_vec, NULL, 0, size, p_vec->type == vec_type ? VEC_CACHE_LINE_SIZE : sizeof(void*));
+#endif
+        // the last time the elements move
+        if (p_old_data) {
+            memcpy(p_data, p_old_data, p_vec->count * element_size);
+#ifdef __linux__
+            if (p_vec->flags & VEC_FLAG_MAPPED) {
+                munmap(p_old_data, _vec_GetMappedSize(p_vec->capacity * element_size));
+            } else
+#endif
+            {
+                _vec_Free(p_vec, p_old_data, p_vec->capacity * element_size);
+            }
+        }
+        p_vec->p_data = p_data;
+        if (p_vec->p_occupancy) {
+            // the bits are laid out for the old capacity
+            Uint64* p_occupancy = _vec_Alloc(p_vec, NULL, 0, _vec_GetOccupancySize(max_capacity), sizeof(Uint64));
+            size_t old_words_count = _vec_GetOccupancyWordsCount(p_vec->capacity);
+            size_t words_count = _vec_GetOccupancyWordsCount(max_capacity);
+            memset(p_occupancy, 0, words_count * sizeof(Uint64));
+            memcpy(p_occupancy, p_vec->p_occupancy, old_words_count * sizeof(Uint64));
+            _vec_Free(p_vec, p_vec->p_occupancy, _vec_GetOccupancySize(p_vec->capacity));
+            p_vec->p_occupancy = p_occupancy;
+        }
+        p_vec->capacity = max_capacity;
+#ifdef __linux__
+        p_vec->flags |= VEC_FLAG_MAPPED;
+#endif
+        p_vec->flags |= VEC_FLAG_STABLE;
+        if (p_vec->type == vec_type) {
+            _vec_RelinkChildren(p_vec, 0, p_vec->count);
+            _vec_BumpGeneration(p_vec);
+        }
+    }
+    bool vec_HasStableAddresses(Vec* p_vec) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        return p_vec->flags & VEC_FLAG_STABLE;
+    }
+    void vec_SetCountUninitialized_UnsafeWrite(Vec* p_vec, size_t count) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->type != vec_type, "child Vecs have to be null before they are initialized");
+        DEBUG_SCOPE(_vec_SetCount(p_vec, count, false));
+    }
+
+// ================================================================================================================================
+// Bulk
+// ================================================================================================================================
+    void vec_InsertElements_UnsafeWrite(Vec* p_vec, size_t index, size_t count, const void* p_src_data) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(index <= p_vec->count, "index(%zu) is out of bounds(%zu)", index, p_vec->count);
+        DEBUG_ASSERT(p_vec->type != vec_type || !p_src_data, "child Vecs cannot be copied in. insert null ones and initialize them");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_STABLE) || index == p_vec->count, "elements of a stable vec never move so it can only be appended to");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_COLUMNAR), "p_vec = %p | elements of a columnar vec are only stored field by field", p_vec);
+        if (count == 0) {
+            return;
+        }
+        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+        size_t old_count = p_vec->count;
+        DEBUG_SCOPE(_vec_Reserve(p_vec, old_count + count));
+        unsigned char* p_at = p_vec->p_data + index * element_size;
+        memmove(p_at + count * element_size, p_at, (old_count - index) * element_size);
+        if (p_src_data) {
+            memcpy(p_at, p_src_data, count * element_size);
+        } else {
+            memset(p_at, 0, count * element_size);
+        }
+        p_vec->count = old_count + count;
+        _vec_MoveOccupancy(p_vec, index, index + count, old_count - index);
+        _vec_SetOccupancy(p_vec, index, index + count, true);
+        if (index < old_count) {
+            _vec_RebuildFreeIndices(p_vec);
+            if (p_vec->type == vec_type) {
+                _vec_RelinkChildren(p_vec, index + count, p_vec->count);
+                DEBUG_SCOPE(_vec_TypeIndices_Rebuild(p_vec));
+                _vec_BumpGeneration(p_vec);
+            }
+        }
+    }
+    void vec_AppendElements_UnsafeWrite(Vec* p_vec, size_t count, const void* p_src_data) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_SCOPE(vec_InsertElements_UnsafeWrite(p_vec, p_vec->count, count, p_src_data));
+    }
+    void vec_RemoveElements_UnsafeWrite(Vec* p_vec, size_t index, size_t count) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(index + count <= p_vec->count, "index(%zu) + count(%zu) is out of bounds(%zu)", index, count, p_vec->count);
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_STABLE) || index + count == p_vec->count, "elements of a stable vec never move so it can only be removed from at the end");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_COLUMNAR), "p_vec = %p | elements of a columnar vec are only stored field by field", p_vec);
+        if (count == 0) {
+            return;
+        }
+        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+        DEBUG_SCOPE(Type_Destructor type_destructor = type_GetTypeInfo_Safe(p_vec->type).destructor);
+        // destroyed elements were already destructed once and null child Vecs were never initialized
+        for (size_t i = _vec_GetNextLiveIndex(p_vec, index); type_destructor && i != SIZE_MAX && i < index + count; i = _vec_GetNextLiveIndex(p_vec, i + 1)) {
+            unsigned char* p_element = p_vec->p_data + i * element_size;
+            if (p_vec->type != vec_type || ((Vec*)p_element)->id) {
+                type_destructor(p_element);
+            }
+        }
+        size_t old_count = p_vec->count;
+        unsigned char* p_at = p_vec->p_data + index * element_size;
+        memmove(p_at, p_at + count * element_size, (old_count - index - count) * element_size);
+        _vec_MoveOccupancy(p_vec, index + count, index, old_count - index - count);
+        _vec_SetOccupancy(p_vec, old_count - count, old_count, false);
+        p_vec->count = old_count - count;
+        _vec_RebuildFreeIndices(p_vec);
+        if (p_vec->type == vec_type) {
+            _vec_RelinkChildren(p_vec, index, p_vec->count);
+            DEBUG_SCOPE(_vec_TypeIndices_Rebuild(p_vec));
+            _vec_BumpGeneration(p_vec);
+        }
+    }
+    void vec_OverwriteFromOther_UnsafeWrite(Vec* p_vec, size_t index, Vec* p_other_vec, size_t other_index, size_t count) {
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_other_vec), "p_other_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->type == p_other_vec->type, "element types are not the same");
+        DEBUG_ASSERT(p_vec->type != vec_type, "child Vecs cannot be copied");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_COLUMNAR), "p_vec = %p | elements of a columnar vec are only stored field by field", p_vec);
+        DEBUG_ASSERT(index + count <= p_vec->count, "index+count is out of dst array bounds");
+        DEBUG_ASSERT(other_index + count <= p_other_vec->count, "index+count is out of src array bounds");
+        DEBUG_SCOPE(unsigned int element_size = type_GetSize_Safe(p_vec->type));
+        // the ranges overlap when both are the same Vec
+        memmove(p_vec->p_data + index * element_size, p_other_vec->p_data + other_index * element_size, count * element_size);
+    }
+    void vec_InsertElements_SafeWrite(Vec* p_vec, size_t index, size_t count, const void* p_src_data) {
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+        DEBUG_SCOPE(vec_InsertElements_UnsafeWrite(p_vec, index, count, p_src_data));
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
+    void vec_AppendElements_SafeWrite(Vec* p_vec, size_t count, const void* p_src_data) {
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+        DEBUG_SCOPE(vec_AppendElements_UnsafeWrite(p_vec, count, p_src_data));
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
+    void vec_RemoveElements_SafeWrite(Vec* p_vec, size_t index, size_t count) {
+        DEBUG_SCOPE(vec_LockWrite(p_vec));
+        DEBUG_SCOPE(vec_RemoveElements_UnsafeWrite(p_vec, index, count));
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
+    static size_t _vec_GetDepth(Vec* p_vec) {
+        size_t depth = 0;
+        for (p_vec = p_vec->p_parent; p_vec; p_vec = p_vec->p_parent) {
+            depth++;
+        }
+        return depth;
+    }
+    // whether p_a is locked before p_b in the order of _vec_Transaction_CompareNodes, ancestors before descendants and
+    // otherwise the lower index below the deepest common ancestor first. siblings are stored back to back in their
+    // parent's p_data so their addresses compare like their indices
+    static bool _vec_IsLockedBefore(Vec* p_a, Vec* p_b) {
+        size_t depth_a = _vec_GetDepth(p_a);
+        size_t depth_b = _vec_GetDepth(p_b);
+        Vec* p_ancestor_a = p_a;
+        Vec* p_ancestor_b = p_b;
+        for (; depth_a > depth_b; --depth_a) {
+            p_ancestor_a = p_ancestor_a->p_parent;
+        }
+        for (; depth_b > depth_a; --depth_b) {
+            p_ancestor_b = p_ancestor_b->p_parent;
+        }
+        if (p_ancestor_a == p_ancestor_b) {
+            return p_ancestor_a == p_a;
+        }
+        // Vecs of different trees meet at NULL and are ordered by their roots
+        while (p_ancestor_a->p_parent != p_ancestor_b->p_parent) {
+            p_ancestor_a = p_ancestor_a->p_parent;
+            p_ancestor_b = p_ancestor_b->p_parent;
+        }
+        return p_ancestor_a < p_ancestor_b;
+    }
+    void vec_OverwriteFromOther_SafeWrite(Vec* p_vec, size_t index, Vec* p_other_vec, size_t other_index, size_t count) {
+        if (p_vec == p_other_vec) {
+            DEBUG_SCOPE(vec_LockWrite(p_vec));
+            DEBUG_SCOPE(vec_OverwriteFromOther_UnsafeWrite(p_vec, index, p_other_vec, other_index, count));
+            DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+            return;
+        }
+        // the same order transactions lock in, so this can neither deadlock with a copy in the opposite direction nor
+        // with a transaction holding one of the two and waiting for the other
+        if (_vec_IsLockedBefore(p_vec, p_other_vec)) {
+            DEBUG_SCOPE(vec_LockWrite(p_vec));
+            DEBUG_SCOPE(vec_LockRead(p_other_vec));
+        } else {
+            DEBUG_SCOPE(vec_LockRead(p_other_vec));
+            DEBUG_SCOPE(vec_LockWrite(p_vec));
+        }
+        DEBUG_SCOPE(vec_OverwriteFromOther_UnsafeWrite(p_vec, index, p_other_vec, other_index, count));
+        DEBUG_SCOPE(vec_UnlockRead(p_other_vec));
+        DEBUG_SCOPE(vec_UnlockWrite(p_vec));
+    }
 
-/*
-void vec_CopyElement_SafeRead(
-	Vec* p_vec, 
-	unsigned int index, 
-	void** const pp_dst_data, 
-	unsigned int* p_dst_data_size) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	SDL_LockRWLockForReading(p_vec->p_rwlock);
-	DEBUG_ASSERT(p_vec->p_data, "NULL pointer");
-	DEBUG_ASSERT(p_vec->count <= p_vec->capacity, "Count is greater than capacity");
-	DEBUG_ASSERT(p_vec->count > index, "Index out of bounds");
-	DEBUG_ASSERT(pp_dst_data, "NULL pointer");
-	if (*p_dst_data_size < p_vec->element_size || *pp_dst_data == NULL) {
-		*p_dst_data_size = p_vec->element_size;
-		DEBUG_SCOPE(*pp_dst_data = alloc(*pp_dst_data, p_vec->element_size));
-	}
-	if (p_vec->this_type == p_vec->type) {
-		SDL_RWLock* p_sub_rwlock = ((Vec*)&p_vec->p_data[index*p_vec->element_size])->p_rwlock;
-		DEBUG_ASSERT(p_sub_rwlock, "NULL pointer");
-		SDL_LockRWLockForReading(p_sub_rwlock);
-		memcpy(*pp_dst_data, (unsigned char*)(p_vec->p_data)+index*p_vec->element_size, p_vec->element_size);
-		SDL_UnlockRWLock(p_sub_rwlock);
-	} else {
-		memcpy(*pp_dst_data, (unsigned char*)(p_vec->p_data)+index*p_vec->element_size, p_vec->element_size);
-	}
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_CopyElements_SafeRead(
-	Vec* p_vec, 
-	unsigned int index, 
-	unsigned int count, 
-	void** const pp_dst_data, 
-	unsigned int* p_dst_data_size) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	SDL_LockRWLockForReading(p_vec->p_rwlock);
-	DEBUG_ASSERT(p_vec->p_data, "NULL pointer");
-	DEBUG_ASSERT(p_vec->count <= p_vec->capacity, "Count is greater than capacity");
-	DEBUG_ASSERT(p_vec->count >= index*count, "Index out of bounds");
-	DEBUG_ASSERT(pp_dst_data, "NULL pointer");
-	if (*p_dst_data_size < count*p_vec->element_size || *pp_dst_data == NULL) {
-		*p_dst_data_size = count*p_vec->element_size;
-		DEBUG_SCOPE(*pp_dst_data = alloc(*pp_dst_data, count*p_vec->element_size));
-	}
-	if (p_vec->this_type == p_vec->type) {
-		void* p_sub_rwlock = (unsigned char*)(p_vec->p_data)+index*p_vec->element_size;
-		for (unsigned int i = 0; i < count; ++i) {
-			DEBUG_ASSERT((SDL_RWLock*)p_sub_rwlock, "NULL pointer");
-			SDL_LockRWLockForReading((SDL_RWLock*)p_sub_rwlock);
-			p_sub_rwlock += p_vec->element_size;
-		}
-		memcpy(*pp_dst_data, (unsigned char*)(p_vec->p_data)+index*p_vec->element_size, count*p_vec->element_size);
-		p_sub_rwlock -= count * p_vec->element_size;
-		for (unsigned int i = 0; i < count; ++i) {
-			DEBUG_ASSERT((SDL_RWLock*)p_sub_rwlock, "NULL pointer");
-			SDL_UnlockRWLock((SDL_RWLock*)p_sub_rwlock);
-			p_sub_rwlock += p_vec->element_size;
-		}
-	} else {
-		memcpy(*pp_dst_data, (unsigned char*)(p_vec->p_data)+index*p_vec->element_size, count*p_vec->element_size);
-	}
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-
-// ================================================================================================================================
-// Locks writing
-// ================================================================================================================================
-void vec_SetCount_UnsafeWrite(
-	Vec* p_vec, 
-	unsigned int count) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	if (p_vec->count < count) {
-		if (count > p_vec->capacity) {
-			unsigned int new_capacity = 1;
-			while (count >= new_capacity) {
-				new_capacity*=2;
-			}
-			DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, new_capacity*p_vec->element_size));
-			p_vec->capacity = new_capacity;
-		}
-		memset(&((unsigned char*)p_vec->p_data)[p_vec->count*p_vec->element_size], 0, (count-p_vec->count)*p_vec->element_size);
-		// if elements are Vec as well then rwlock needs to be created
-		if (p_vec->this_type == p_vec->type) {
-			Vec* p_sub_vec = (Vec*)(p_vec->p_data);
-			for (unsigned int i = p_vec->count; i < count; ++i) {
-				p_sub_vec[i].p_rwlock = SDL_CreateRWLock();
-			}
-		}
-	}
-	p_vec->count = count;
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_SetCapacity_SafeWrite(
-	Vec* p_vec, 
-	unsigned int capacity) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	if (p_vec->capacity != capacity) {
-		DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, capacity*p_vec->element_size));
-		p_vec->capacity = capacity;
-		if (p_vec->count > capacity) {
-			p_vec->capacity = capacity;
-		}
-	}
-	SDL_UnlockRWLock(p_vec->p_rwlock);	
-}
-void vec_OverwriteElement_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index,
-	const void * const p_src_data) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	DEBUG_ASSERT(p_src_data, "NULL pointer");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	DEBUG_ASSERT(p_vec->count > index, "index is out of bounds");
-	DEBUG_ASSERT(p_vec->count <= p_vec->capacity, "Count is greater than capacity");
-	memcpy((unsigned char*)(p_vec->p_data)+index*p_vec->element_size, p_src_data, p_vec->element_size);
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_OverwriteElements_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index, 
-	unsigned int count, 
-	const void * const p_src_data) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	DEBUG_ASSERT(p_src_data, "NULL pointer");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	DEBUG_ASSERT(p_vec->count >= index+count, "index is out of bounds");
-	DEBUG_ASSERT(p_vec->count <= p_vec->capacity, "Count is greater than capacity");
-	memcpy((unsigned char*)(p_vec->p_data)+index*p_vec->element_size, p_src_data, count*p_vec->element_size);
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_OverwriteFromOther_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index, 
-	Vec* p_other_vec, 
-	unsigned int other_index, 
-	unsigned int count) 
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	DEBUG_ASSERT(p_other_vec, "NULL pointer");
-	DEBUG_ASSERT(p_other_vec->p_rwlock, "NULL pointer");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	SDL_LockRWLockForReading(p_other_vec->p_rwlock);
-	DEBUG_ASSERT(p_vec->p_data, "NULL pointer");
-	DEBUG_ASSERT(p_other_vec->p_data, "NULL pointer");
-	DEBUG_ASSERT(p_vec->type == p_other_vec->type, "element types are not the same");
-	DEBUG_ASSERT(p_vec->element_size == p_other_vec->element_size, "element sizes are not the same");
-	DEBUG_ASSERT(p_vec->count >= index+count, "index+count is out of dst array bounds");
-	DEBUG_ASSERT(p_other_vec->count >= other_index+count, "index+count is out of src array bounds");
-	DEBUG_ASSERT(p_vec->count <= p_vec->capacity, "count is greater than capacity in dst");
-	DEBUG_ASSERT(p_other_vec->count <= p_other_vec->capacity, "count is greater than capacity in src");
-	unsigned int size = p_vec->element_size;
-	memcpy((unsigned char*)(p_vec->p_data)+index*size, p_other_vec->p_data + other_index*size, count*size);
-	SDL_UnlockRWLock(p_other_vec->p_rwlock);
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_AppendElement_SafeWrite(
-	Vec* p_vec,
-	const void * const p_src_data)
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	DEBUG_ASSERT(p_src_data, "NULL pointer");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	if (p_vec->count >= p_vec->capacity) {
-		unsigned int new_capacity = 1;
-		while(p_vec->count >= new_capacity) {
-			new_capacity*=2;
-		}
-		DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, new_capacity*p_vec->element_size));
-	}
-	memcpy((unsigned char*)(p_vec->p_data)+p_vec->count*p_vec->element_size, p_src_data, p_vec->element_size);
-	p_vec->count++;
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_AppendElements_SafeWrite(
-	Vec* p_vec, 
-	unsigned int count, 
-	const void * const p_src_data)
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	DEBUG_ASSERT(p_src_data, "NULL pointer");
-	SDL_LockRWLockForWriting(p_vec->p_rwlock);
-	if (p_vec->count + count >= p_vec->capacity) {
-		unsigned int new_capacity = 1;
-		while(p_vec->count + count >= new_capacity) {
-			new_capacity*=2;
-		}
-		DEBUG_SCOPE(p_vec->p_data = alloc(p_vec->p_data, new_capacity*p_vec->element_size));
-	}
-	memcpy((unsigned char*)(p_vec->p_data)+p_vec->count*p_vec->element_size, p_src_data, count*p_vec->element_size);
-	p_vec->count += count;
-	SDL_UnlockRWLock(p_vec->p_rwlock);
-}
-void vec_InsertElement_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index, 
-	const void * const p_src_data) 
-{}
-void vec_InsertElements_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index, 
-	unsigned int count, 
-	const void * const p_src_data) 
-{}
-void vec_RemoveElementBack_SafeWrite(
-	Vec* p_vec)
-{}
-void vec_RemoveElementsBack_SafeWrite(
-	Vec* p_vec, 
-	unsigned int count) 
-{}
-void vec_RemoveElement_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index)
-{}
-void vec_RemoveElements_SafeWrite(
-	Vec* p_vec, 
-	unsigned int index, 
-	unsigned int count)
-{}
-void vec_Destroy_SafeWrite(
-	Vec* p_vec)
-{
-	DEBUG_ASSERT(vec_IsValid_SafeRead(p_vec), "p_vec is invalid\n");
-	SDL_DestroyRWLock(p_vec->p_rwlock);
-}
-*/
\ No newline at end of file
+// ================================================================================================================================
+// Columns
+// ================================================================================================================================
+    void vec_SetColumnar_UnsafeWrite(Vec* p_vec) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->count == 0, "p_vec = %p | only an empty vec can become columnar", p_vec);
+        DEBUG_ASSERT(p_vec->type != vec_type, "child Vecs are always stored whole");
+        DEBUG_ASSERT(!(p_vec->flags & VEC_FLAG_STABLE), "p_vec = %p | columns move apart whenever the capacity changes", p_vec);
+        DEBUG_ASSERT(!type_GetDestructor_Safe(p_vec->type), "p_vec = %p | a destructor needs whole elements", p_vec);
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        ASSERT(p_fields, "p_vec = %p | type %s has no fields", p_vec, type_GetName_Safe(p_vec->type));
+        if (p_vec->flags & VEC_FLAG_COLUMNAR) {
+            return;
+        }
+        // the storage is laid out again for the columns
+        DEBUG_SCOPE(_vec_ReallocData(p_vec, 0));
+        p_vec->capacity = 0;
+        p_vec->flags |= VEC_FLAG_COLUMNAR;
+    }
+    bool vec_IsColumnar(Vec* p_vec) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        return p_vec->flags & VEC_FLAG_COLUMNAR;
+    }
+    void* vec_GetColumn_UnsafeRead(Vec* p_vec, unsigned int field_index) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->flags & VEC_FLAG_COLUMNAR, "p_vec = %p | is not columnar", p_vec);
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        DEBUG_ASSERT(field_index < fields_count, "field_index(%u) is out of bounds(%u)", field_index, fields_count);
+        if (!p_vec->p_data) {
+            return NULL;
+        }
+        return p_vec->p_data + _vec_GetColumnOffset(p_fields, field_index, p_vec->capacity);
+    }
+    void vec_CopyElementFromColumns_UnsafeRead(Vec* p_vec, size_t index, void* p_element) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->flags & VEC_FLAG_COLUMNAR, "p_vec = %p | is not columnar", p_vec);
+        DEBUG_ASSERT(index < p_vec->count, "index(%zu) is out of bounds(%zu)", index, p_vec->count);
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        size_t offset = 0;
+        for (unsigned int i = 0; i < fields_count; ++i) {
+            memcpy((unsigned char*)p_element + p_fields[i].offset, p_vec->p_data + offset + index * p_fields[i].size, p_fields[i].size);
+            offset += (p_vec->capacity * p_fields[i].size + VEC_CACHE_LINE_SIZE - 1) & ~(size_t)(VEC_CACHE_LINE_SIZE - 1);
+        }
+    }
+    void vec_CopyElementToColumns_UnsafeWrite(Vec* p_vec, size_t index, const void* p_element) {
+    	DEBUG_ASSERT(vec_IsValid_UnsafeRead(p_vec), "p_vec is invalid\n");
+        DEBUG_ASSERT(p_vec->flags & VEC_FLAG_COLUMNAR, "p_vec = %p | is not columnar", p_vec);
+        DEBUG_ASSERT(index < p_vec->count, "index(%zu) is out of bounds(%zu)", index, p_vec->count);
+        unsigned int fields_count;
+        DEBUG_SCOPE(const Type_Field* p_fields = type_GetFields_Safe(p_vec->type, &fields_count));
+        size_t offset = 0;
+        for (unsigned int i = 0; i < fields_count; ++i) {
+            memcpy(p_vec->p_data + offset + index * p_fields[i].size, (const unsigned char*)p_element + p_fields[i].offset, p_fields[i].size);
+            offset += (p_vec->capacity * p_fields[i].size + VEC_CACHE_LINE_SIZE - 1) & ~(size_t)(VEC_CACHE_LINE_SIZE - 1);
+        }
+    }
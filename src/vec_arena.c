@@ -0,0 +1,127 @@
+#include "vec_arena.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+typedef struct Vec_ArenaChunk Vec_ArenaChunk;
+struct Vec_ArenaChunk {
+    Vec_ArenaChunk* p_next;
+    size_t size;
+    size_t used;
+    // child Vecs are allocated from here so the data starts on a cache line
+    unsigned char p_data[] __attribute__((aligned(64)));
+};
+
+struct Vec_Arena {
+    SDL_SpinLock lock;
+    size_t chunk_size;
+    // allocations are bumped through the newest chunk, the older ones are only kept to be freed
+    Vec_ArenaChunk* p_chunk;
+    // the latest allocation from p_chunk, the only one that can change in place
+    unsigned char* p_last;
+    size_t size;
+    // p_user is the arena itself
+    Allocator allocator;
+};
+
+static Vec_ArenaChunk* _vec_Arena_AddChunk(Vec_Arena* p_arena, size_t size) {
+    size = size > p_arena->chunk_size ? size : p_arena->chunk_size;
+    DEBUG_SCOPE(Vec_ArenaChunk* p_chunk = alloc_Aligned(NULL, 0, sizeof(Vec_ArenaChunk) + size, 64));
+    p_chunk->p_next = p_arena->p_chunk;
+    p_chunk->size = size;
+    p_chunk->used = 0;
+    p_arena->p_chunk = p_chunk;
+    p_arena->p_last = NULL;
+    p_arena->size += size;
+    return p_chunk;
+}
+
+static void* _vec_Arena_AllocatorAlloc(void* p_user, size_t size, size_t alignment) {
+    return vec_Arena_Alloc((Vec_Arena*)p_user, NULL, 0, size, alignment);
+}
+static void* _vec_Arena_AllocatorRealloc(void* p_user, void* ptr, size_t old_size, size_t size, size_t alignment) {
+    return vec_Arena_Alloc((Vec_Arena*)p_user, ptr, old_size, size, alignment);
+}
+static void _vec_Arena_AllocatorFree(void* p_user, void* ptr, size_t size) {
+    vec_Arena_Free((Vec_Arena*)p_user, ptr);
+}
+
+Vec_Arena* vec_Arena_Create(size_t chunk_size) {
+    DEBUG_SCOPE(Vec_Arena* p_arena = alloc(NULL, sizeof(Vec_Arena)));
+    p_arena->lock = 0;
+    p_arena->chunk_size = chunk_size ? chunk_size : VEC_ARENA_CHUNK_SIZE;
+    p_arena->p_chunk = NULL;
+    p_arena->p_last = NULL;
+    p_arena->size = 0;
+    p_arena->allocator = (Allocator){
+        .p_alloc = _vec_Arena_AllocatorAlloc,
+        .p_realloc = _vec_Arena_AllocatorRealloc,
+        .p_free = _vec_Arena_AllocatorFree,
+        .p_user = p_arena,
+    };
+    return p_arena;
+}
+void vec_Arena_Destroy(Vec_Arena* p_arena) {
+    DEBUG_ASSERT(p_arena, "NULL pointer");
+    Vec_ArenaChunk* p_chunk = p_arena->p_chunk;
+    while (p_chunk) {
+        Vec_ArenaChunk* p_next = p_chunk->p_next;
+        DEBUG_SCOPE(free(p_chunk));
+        p_chunk = p_next;
+    }
+    DEBUG_SCOPE(free(p_arena));
+}
+void* vec_Arena_Alloc(Vec_Arena* p_arena, void* ptr, size_t old_size, size_t size, size_t alignment) {
+    DEBUG_ASSERT(p_arena, "NULL pointer");
+    DEBUG_ASSERT(alignment && (alignment & (alignment - 1)) == 0 && alignment <= 64, "alignment(%zu) has to be a power of two up to 64", alignment);
+    if (size == 0) {
+        vec_Arena_Free(p_arena, ptr);
+        return NULL;
+    }
+    SDL_LockSpinlock(&p_arena->lock);
+    Vec_ArenaChunk* p_chunk = p_arena->p_chunk;
+    // the latest allocation grows and shrinks without a copy as long as its chunk has room
+    if (ptr && ptr == p_arena->p_last) {
+        size_t offset = (unsigned char*)ptr - p_chunk->p_data;
+        if (offset + size <= p_chunk->size) {
+            p_chunk->used = offset + size;
+            SDL_UnlockSpinlock(&p_arena->lock);
+            return ptr;
+        }
+    }
+    size_t offset = p_chunk ? (p_chunk->used + alignment - 1) & ~(alignment - 1) : 0;
+    if (!p_chunk || offset + size > p_chunk->size) {
+        p_chunk = _vec_Arena_AddChunk(p_arena, size);
+        offset = 0;
+    }
+    unsigned char* p_data = p_chunk->p_data + offset;
+    p_chunk->used = offset + size;
+    p_arena->p_last = p_data;
+    SDL_UnlockSpinlock(&p_arena->lock);
+    if (ptr) {
+        memcpy(p_data, ptr, old_size < size ? old_size : size);
+    }
+    return p_data;
+}
+void vec_Arena_Free(Vec_Arena* p_arena, void* ptr) {
+    DEBUG_ASSERT(p_arena, "NULL pointer");
+    if (!ptr) {
+        return;
+    }
+    SDL_LockSpinlock(&p_arena->lock);
+    // anything older than the latest allocation is given back with the whole arena
+    if (ptr == p_arena->p_last) {
+        p_arena->p_chunk->used = (unsigned char*)ptr - p_arena->p_chunk->p_data;
+        p_arena->p_last = NULL;
+    }
+    SDL_UnlockSpinlock(&p_arena->lock);
+}
+size_t vec_Arena_GetSize(Vec_Arena* p_arena) {
+    DEBUG_ASSERT(p_arena, "NULL pointer");
+    return p_arena->size;
+}
+const Allocator* vec_Arena_GetAllocator(Vec_Arena* p_arena) {
+    DEBUG_ASSERT(p_arena, "NULL pointer");
+    return &p_arena->allocator;
+}
@@ -0,0 +1,452 @@
+#include "vec.h"
+#include "type.h"
+#include "debug.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+// ================================================================================================================================
+// Vec lock benchmark
+//
+// Policies: measures how long a single writer waits for vec_LockWrite while reader threads keep the same Vec read locked
+// back to back, once for every Vec_LockPolicy.
+// Siblings: every thread locks its own child of one parent Vec, so any slowdown as threads are added comes from the
+// children sharing cache lines. Separately allocated root Vecs are measured next to it as the ideal.
+// Depth: every thread moves down a chain of nested Vecs and back, once with a lock per node and once with the chain
+// under a single coarse root.
+// Replicated: every thread read locks the same Vec back to back, once counted in the lock word and once replicated.
+// Columns: moves every rect of a Vec by its size, once with whole rects stored back to back and once columnar, where
+// the pass only reads the four columns it needs.
+// Usage: vec_bench [reader_threads] [duration_ms]
+// ================================================================================================================================
+#define BENCH_MAX_WRITES        200000
+#define BENCH_READ_WORK         256
+#define BENCH_WRITE_GAP_NS      20000
+#define BENCH_DEPTH             5
+#define BENCH_RECTS_COUNT       (1 << 20)
+
+typedef struct Bench {
+    Vec*            p_vec;
+    SDL_AtomicInt   stop;
+    SDL_AtomicInt   reads;
+    Uint64*         p_latencies;
+    unsigned int    writes;
+} Bench;
+
+typedef struct Bench_Depth {
+    Vec*            p_root;
+    SDL_AtomicInt*  p_stop;
+    Uint64          moves;
+} Bench_Depth;
+
+typedef struct Bench_Sibling {
+    Vec*            p_vec;
+    SDL_AtomicInt*  p_stop;
+    Uint64          locks;
+} Bench_Sibling;
+
+// laid out like Rect in cpi.h
+typedef struct Bench_Rect {
+    struct { float x, y, w, h; }            rect;
+    float                                   rotation;
+    float                                   corner_radius_pixels;
+    struct { unsigned char r, g, b, a; }    color;
+    unsigned int                            tex_index;
+    struct { float x, y, w, h; }            tex_rect;
+} Bench_Rect;
+static const Type_Field bench_rect_fields[] = {
+    {"x", offsetof(Bench_Rect, rect.x), sizeof(float)},
+    {"y", offsetof(Bench_Rect, rect.y), sizeof(float)},
+    {"w", offsetof(Bench_Rect, rect.w), sizeof(float)},
+    {"h", offsetof(Bench_Rect, rect.h), sizeof(float)},
+    {"rotation", offsetof(Bench_Rect, rotation), sizeof(float)},
+    {"corner_radius_pixels", offsetof(Bench_Rect, corner_radius_pixels), sizeof(float)},
+    {"color", offsetof(Bench_Rect, color), sizeof(((Bench_Rect*)0)->color)},
+    {"tex_index", offsetof(Bench_Rect, tex_index), sizeof(unsigned int)},
+    {"tex_rect", offsetof(Bench_Rect, tex_rect), sizeof(((Bench_Rect*)0)->tex_rect)},
+};
+
+static Type bench_int_type = 0;
+static Type bench_rect_type = 0;
+
+static int _bench_Reader(void* p_data) {
+    Bench* p_bench = (Bench*)p_data;
+    int reads = 0;
+    volatile int sink = 0;
+    while (!SDL_GetAtomicInt(&p_bench->stop)) {
+        vec_LockRead(p_bench->p_vec);
+        int value = *(int*)vec_GetElement_UnsafeRead(p_bench->p_vec, 0, bench_int_type);
+        for (int i = 0; i < BENCH_READ_WORK; ++i) {
+            sink += value;
+        }
+        vec_UnlockRead(p_bench->p_vec);
+        reads++;
+    }
+    SDL_AddAtomicInt(&p_bench->reads, reads);
+    return 0;
+}
+static int _bench_Writer(void* p_data) {
+    Bench* p_bench = (Bench*)p_data;
+    while (!SDL_GetAtomicInt(&p_bench->stop) && p_bench->writes < BENCH_MAX_WRITES) {
+        Uint64 start = SDL_GetTicksNS();
+        vec_LockWrite(p_bench->p_vec);
+        (*(int*)vec_GetElement_UnsafeRead(p_bench->p_vec, 0, bench_int_type))++;
+        vec_UnlockWrite(p_bench->p_vec);
+        Uint64 end = SDL_GetTicksNS();
+        p_bench->p_latencies[p_bench->writes++] = end - start;
+        while (SDL_GetTicksNS() - end < BENCH_WRITE_GAP_NS) {
+            SDL_CPUPauseInstruction();
+        }
+    }
+    return 0;
+}
+static int _bench_CompareLatency(const void* p_a, const void* p_b) {
+    Uint64 a = *(const Uint64*)p_a;
+    Uint64 b = *(const Uint64*)p_b;
+    return (a > b) - (a < b);
+}
+static Uint64 _bench_Percentile(Bench* p_bench, double percentile) {
+    if (p_bench->writes == 0) {
+        return 0;
+    }
+    unsigned int index = (unsigned int)(percentile * (p_bench->writes - 1));
+    return p_bench->p_latencies[index];
+}
+static void _bench_Run(Vec_LockPolicy lock_policy, const char* name, int reader_count, unsigned int duration_ms) {
+    Vec* p_vec = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+    memset(p_vec, 0, sizeof(Vec));
+    vec_Initialize(p_vec, NULL, bench_int_type);
+    vec_SetLockPolicy(p_vec, lock_policy);
+    vec_LockWrite(p_vec);
+    int index = vec_UpsertNullElement_UnsafeWrite(p_vec, bench_int_type);
+    ASSERT(index == 0, "expected the first element to be at index 0");
+    vec_UnlockWrite(p_vec);
+
+    Bench bench = {0};
+    bench.p_vec = p_vec;
+    bench.p_latencies = alloc(NULL, BENCH_MAX_WRITES * sizeof(Uint64));
+
+    SDL_Thread** p_readers = alloc(NULL, reader_count * sizeof(SDL_Thread*));
+    for (int i = 0; i < reader_count; ++i) {
+        p_readers[i] = SDL_CreateThread(_bench_Reader, "vec_bench_reader", &bench);
+        ASSERT(p_readers[i], "failed to create reader thread: %s", SDL_GetError());
+    }
+    SDL_Thread* p_writer = SDL_CreateThread(_bench_Writer, "vec_bench_writer", &bench);
+    ASSERT(p_writer, "failed to create writer thread: %s", SDL_GetError());
+
+    SDL_Delay(duration_ms);
+    SDL_SetAtomicInt(&bench.stop, 1);
+    SDL_WaitThread(p_writer, NULL);
+    for (int i = 0; i < reader_count; ++i) {
+        SDL_WaitThread(p_readers[i], NULL);
+    }
+
+    qsort(bench.p_latencies, bench.writes, sizeof(Uint64), _bench_CompareLatency);
+    printf("%-16s writes %8u | write wait us p50 %10.1f p99 %10.1f p99.9 %10.1f max %10.1f | reads/s %12.0f\n",
+        name,
+        bench.writes,
+        _bench_Percentile(&bench, 0.50) / 1000.0,
+        _bench_Percentile(&bench, 0.99) / 1000.0,
+        _bench_Percentile(&bench, 0.999) / 1000.0,
+        _bench_Percentile(&bench, 1.0) / 1000.0,
+        SDL_GetAtomicInt(&bench.reads) * 1000.0 / duration_ms);
+
+    free(p_readers);
+    free(bench.p_latencies);
+    vec_Destroy(p_vec);
+    free(p_vec);
+}
+
+static int _bench_SiblingLocker(void* p_data) {
+    Bench_Sibling* p_sibling = (Bench_Sibling*)p_data;
+    Uint64 locks = 0;
+    while (!SDL_GetAtomicInt(p_sibling->p_stop)) {
+        if (locks % 4 == 0) {
+            vec_LockWrite(p_sibling->p_vec);
+            vec_UnlockWrite(p_sibling->p_vec);
+        } else {
+            vec_LockRead(p_sibling->p_vec);
+            vec_UnlockRead(p_sibling->p_vec);
+        }
+        locks++;
+    }
+    p_sibling->locks = locks;
+    return 0;
+}
+static double _bench_LockThreads(Vec** pp_vecs, int thread_count, unsigned int duration_ms) {
+    SDL_AtomicInt stop;
+    SDL_SetAtomicInt(&stop, 0);
+    Bench_Sibling* p_siblings = alloc(NULL, thread_count * sizeof(Bench_Sibling));
+    SDL_Thread** p_threads = alloc(NULL, thread_count * sizeof(SDL_Thread*));
+    for (int i = 0; i < thread_count; ++i) {
+        p_siblings[i].p_vec = pp_vecs[i];
+        p_siblings[i].p_stop = &stop;
+        p_siblings[i].locks = 0;
+        p_threads[i] = SDL_CreateThread(_bench_SiblingLocker, "vec_bench_sibling", &p_siblings[i]);
+        ASSERT(p_threads[i], "failed to create sibling thread: %s", SDL_GetError());
+    }
+    SDL_Delay(duration_ms);
+    SDL_SetAtomicInt(&stop, 1);
+    Uint64 locks = 0;
+    for (int i = 0; i < thread_count; ++i) {
+        SDL_WaitThread(p_threads[i], NULL);
+        locks += p_siblings[i].locks;
+    }
+    free(p_threads);
+    free(p_siblings);
+    return locks * 1000.0 / duration_ms;
+}
+static void _bench_RunSiblings(int max_thread_count, unsigned int duration_ms) {
+    Vec* p_parent = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+    memset(p_parent, 0, sizeof(Vec));
+    vec_Initialize(p_parent, NULL, vec_type);
+    vec_LockWrite(p_parent);
+    for (int i = 0; i < max_thread_count; ++i) {
+        vec_AppendVecWithType_UnsafeWrite(p_parent, bench_int_type);
+    }
+    vec_UnlockWrite(p_parent);
+
+    Vec** pp_siblings = alloc(NULL, max_thread_count * sizeof(Vec*));
+    Vec** pp_roots = alloc(NULL, max_thread_count * sizeof(Vec*));
+    for (int i = 0; i < max_thread_count; ++i) {
+        pp_siblings[i] = (Vec*)vec_GetElement_UnsafeRead(p_parent, i, vec_type);
+        pp_roots[i] = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+        memset(pp_roots[i], 0, sizeof(Vec));
+        vec_Initialize(pp_roots[i], NULL, bench_int_type);
+    }
+
+    printf("sibling locking, %u ms per run, Vec is %zu bytes\n", duration_ms, sizeof(Vec));
+    for (int thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        double siblings = _bench_LockThreads(pp_siblings, thread_count, duration_ms);
+        double roots = _bench_LockThreads(pp_roots, thread_count, duration_ms);
+        printf("threads %3d | siblings locks/s %14.0f | separate roots locks/s %14.0f | siblings/roots %5.2f\n",
+            thread_count, siblings, roots, roots > 0 ? siblings / roots : 0.0);
+    }
+
+    for (int i = 0; i < max_thread_count; ++i) {
+        vec_Destroy(pp_roots[i]);
+        free(pp_roots[i]);
+    }
+    free(pp_roots);
+    free(pp_siblings);
+    vec_Destroy(p_parent);
+    free(p_parent);
+}
+
+static int _bench_DepthMover(void* p_data) {
+    Bench_Depth* p_depth = (Bench_Depth*)p_data;
+    const int p_indices[BENCH_DEPTH] = {0};
+    Uint64 moves = 0;
+    while (!SDL_GetAtomicInt(p_depth->p_stop)) {
+        Vec_Cursor cursor;
+        Vec** pp_vec = vec_MoveStart(&cursor, p_depth->p_root);
+        vec_MoveToIndices(pp_vec, BENCH_DEPTH, p_indices);
+        vec_MoveEnd(pp_vec);
+        moves++;
+    }
+    p_depth->moves = moves;
+    return 0;
+}
+static double _bench_MoveThreads(Vec* p_root, int thread_count, unsigned int duration_ms) {
+    SDL_AtomicInt stop;
+    SDL_SetAtomicInt(&stop, 0);
+    Bench_Depth* p_depths = alloc(NULL, thread_count * sizeof(Bench_Depth));
+    SDL_Thread** p_threads = alloc(NULL, thread_count * sizeof(SDL_Thread*));
+    for (int i = 0; i < thread_count; ++i) {
+        p_depths[i].p_root = p_root;
+        p_depths[i].p_stop = &stop;
+        p_depths[i].moves = 0;
+        p_threads[i] = SDL_CreateThread(_bench_DepthMover, "vec_bench_depth", &p_depths[i]);
+        ASSERT(p_threads[i], "failed to create depth thread: %s", SDL_GetError());
+    }
+    SDL_Delay(duration_ms);
+    SDL_SetAtomicInt(&stop, 1);
+    Uint64 moves = 0;
+    for (int i = 0; i < thread_count; ++i) {
+        SDL_WaitThread(p_threads[i], NULL);
+        moves += p_depths[i].moves;
+    }
+    free(p_threads);
+    free(p_depths);
+    return moves * 1000.0 / duration_ms;
+}
+static void _bench_RunDepth(int max_thread_count, unsigned int duration_ms) {
+    Vec* p_root = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+    memset(p_root, 0, sizeof(Vec));
+    vec_Initialize(p_root, NULL, vec_type);
+    vec_LockWrite(p_root);
+    Vec* p_current = p_root;
+    for (int depth = 1; depth < BENCH_DEPTH; ++depth) {
+        vec_AppendVecWithType_UnsafeWrite(p_current, vec_type);
+        p_current = (Vec*)vec_GetElement_UnsafeRead(p_current, 0, vec_type);
+    }
+    vec_AppendVecWithType_UnsafeWrite(p_current, bench_int_type);
+    vec_UnlockWrite(p_root);
+
+    printf("moving %d levels down and back, %u ms per run\n", BENCH_DEPTH, duration_ms);
+    for (int thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        double per_node = _bench_MoveThreads(p_root, thread_count, duration_ms);
+        vec_LockWrite(p_root);
+        vec_SetLockGranularity(p_root, VEC_LOCK_GRANULARITY_COARSE);
+        vec_UnlockWrite(p_root);
+        double coarse = _bench_MoveThreads(p_root, thread_count, duration_ms);
+        vec_LockWrite(p_root);
+        vec_SetLockGranularity(p_root, VEC_LOCK_GRANULARITY_PER_NODE);
+        vec_UnlockWrite(p_root);
+        printf("threads %3d | per node moves/s %14.0f | coarse moves/s %14.0f | coarse/per node %5.2f\n",
+            thread_count, per_node, coarse, per_node > 0 ? coarse / per_node : 0.0);
+    }
+
+    vec_Destroy(p_root);
+    free(p_root);
+}
+
+static int _bench_ReadLocker(void* p_data) {
+    Bench_Sibling* p_sibling = (Bench_Sibling*)p_data;
+    Uint64 locks = 0;
+    while (!SDL_GetAtomicInt(p_sibling->p_stop)) {
+        vec_LockRead(p_sibling->p_vec);
+        vec_UnlockRead(p_sibling->p_vec);
+        locks++;
+    }
+    p_sibling->locks = locks;
+    return 0;
+}
+static double _bench_ReadThreads(Vec* p_vec, int thread_count, unsigned int duration_ms) {
+    SDL_AtomicInt stop;
+    SDL_SetAtomicInt(&stop, 0);
+    Bench_Sibling* p_readers = alloc(NULL, thread_count * sizeof(Bench_Sibling));
+    SDL_Thread** p_threads = alloc(NULL, thread_count * sizeof(SDL_Thread*));
+    for (int i = 0; i < thread_count; ++i) {
+        p_readers[i].p_vec = p_vec;
+        p_readers[i].p_stop = &stop;
+        p_readers[i].locks = 0;
+        p_threads[i] = SDL_CreateThread(_bench_ReadLocker, "vec_bench_reader", &p_readers[i]);
+        ASSERT(p_threads[i], "failed to create reader thread: %s", SDL_GetError());
+    }
+    SDL_Delay(duration_ms);
+    SDL_SetAtomicInt(&stop, 1);
+    Uint64 locks = 0;
+    for (int i = 0; i < thread_count; ++i) {
+        SDL_WaitThread(p_threads[i], NULL);
+        locks += p_readers[i].locks;
+    }
+    free(p_threads);
+    free(p_readers);
+    return locks * 1000.0 / duration_ms;
+}
+static void _bench_RunReplicated(int max_thread_count, unsigned int duration_ms) {
+    Vec* p_vec = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+    memset(p_vec, 0, sizeof(Vec));
+    vec_Initialize(p_vec, NULL, bench_int_type);
+
+    printf("read locking one Vec, %u ms per run\n", duration_ms);
+    for (int thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        double shared = _bench_ReadThreads(p_vec, thread_count, duration_ms);
+        vec_LockWrite(p_vec);
+        vec_SetReplicatedReading(p_vec, true);
+        vec_UnlockWrite(p_vec);
+        double replicated = _bench_ReadThreads(p_vec, thread_count, duration_ms);
+        vec_LockWrite(p_vec);
+        vec_SetReplicatedReading(p_vec, false);
+        vec_UnlockWrite(p_vec);
+        printf("threads %3d | lock word locks/s %14.0f | replicated locks/s %14.0f | replicated/lock word %5.2f\n",
+            thread_count, shared, replicated, shared > 0 ? replicated / shared : 0.0);
+    }
+
+    vec_Destroy(p_vec);
+    free(p_vec);
+}
+
+static Vec* _bench_CreateRects(bool columnar) {
+    Vec* p_vec = alloc_Aligned(NULL, 0, sizeof(Vec), VEC_CACHE_LINE_SIZE);
+    memset(p_vec, 0, sizeof(Vec));
+    vec_Initialize(p_vec, NULL, bench_rect_type);
+    vec_LockWrite(p_vec);
+    if (columnar) {
+        vec_SetColumnar_UnsafeWrite(p_vec);
+    }
+    vec_SetCount_UnsafeWrite(p_vec, BENCH_RECTS_COUNT);
+    for (size_t i = 0; i < BENCH_RECTS_COUNT; ++i) {
+        Bench_Rect rect = {{(float)i, (float)i, 1.0f, 2.0f}, 0.0f, 4.0f, {255, 255, 255, 255}, 0, {0.0f, 0.0f, 1.0f, 1.0f}};
+        if (columnar) {
+            vec_CopyElementToColumns_UnsafeWrite(p_vec, i, &rect);
+        } else {
+            memcpy(vec_GetElement_UnsafeRead(p_vec, i, bench_rect_type), &rect, sizeof(Bench_Rect));
+        }
+    }
+    vec_UnlockWrite(p_vec);
+    return p_vec;
+}
+// returns rects moved per second
+static double _bench_MoveRects(Vec* p_vec, unsigned int duration_ms) {
+    Uint64 passes = 0;
+    Uint64 start = SDL_GetTicksNS();
+    Uint64 end = start + (Uint64)duration_ms * 1000000;
+    Uint64 now = start;
+    vec_LockWrite(p_vec);
+    while (now < end) {
+        if (vec_IsColumnar(p_vec)) {
+            float* p_x = vec_GetColumn_UnsafeRead(p_vec, 0);
+            float* p_y = vec_GetColumn_UnsafeRead(p_vec, 1);
+            float* p_w = vec_GetColumn_UnsafeRead(p_vec, 2);
+            float* p_h = vec_GetColumn_UnsafeRead(p_vec, 3);
+            for (size_t i = 0; i < BENCH_RECTS_COUNT; ++i) {
+                p_x[i] += p_w[i];
+                p_y[i] += p_h[i];
+            }
+        } else {
+            Bench_Rect* p_rects = (Bench_Rect*)vec_GetElement_UnsafeRead(p_vec, 0, bench_rect_type);
+            for (size_t i = 0; i < BENCH_RECTS_COUNT; ++i) {
+                p_rects[i].rect.x += p_rects[i].rect.w;
+                p_rects[i].rect.y += p_rects[i].rect.h;
+            }
+        }
+        passes++;
+        now = SDL_GetTicksNS();
+    }
+    vec_UnlockWrite(p_vec);
+    return passes * (double)BENCH_RECTS_COUNT * 1e9 / (double)(now - start);
+}
+static void _bench_RunColumns(unsigned int duration_ms) {
+    Vec* p_rows = _bench_CreateRects(false);
+    Vec* p_columns = _bench_CreateRects(true);
+    double rows = _bench_MoveRects(p_rows, duration_ms);
+    double columns = _bench_MoveRects(p_columns, duration_ms);
+    printf("moving %d rects, %u ms per layout\n", BENCH_RECTS_COUNT, duration_ms);
+    printf("rows rects/s %14.0f | columns rects/s %14.0f | columns/rows %5.2f\n", rows, columns, rows > 0 ? columns / rows : 0.0);
+    vec_Destroy(p_rows);
+    free(p_rows);
+    vec_Destroy(p_columns);
+    free(p_columns);
+}
+
+int main(int argc, char** argv) {
+    int reader_count = SDL_GetNumLogicalCPUCores() - 1;
+    if (reader_count < 2) {
+        reader_count = 2;
+    }
+    unsigned int duration_ms = 1000;
+    if (argc > 1) {
+        reader_count = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        duration_ms = (unsigned int)atoi(argv[2]);
+    }
+    ASSERT(reader_count > 0, "reader_threads must be greater than 0");
+    ASSERT(duration_ms > 0, "duration_ms must be greater than 0");
+
+    bench_int_type = type_Create_Safe("int", sizeof(int), NULL);
+    bench_rect_type = type_Create_Safe("Bench_Rect", sizeof(Bench_Rect), NULL);
+    type_SetFields_Safe(bench_rect_type, bench_rect_fields, sizeof(bench_rect_fields) / sizeof(Type_Field));
+    printf("%d reader threads, 1 writer thread, %u ms per policy\n", reader_count, duration_ms);
+    _bench_Run(VEC_LOCK_POLICY_READ_PREFERRING, "read_preferring", reader_count, duration_ms);
+    _bench_Run(VEC_LOCK_POLICY_WRITE_PREFERRING, "write_preferring", reader_count, duration_ms);
+    _bench_Run(VEC_LOCK_POLICY_FAIR, "fair", reader_count, duration_ms);
+    _bench_RunSiblings(reader_count + 1, duration_ms);
+    _bench_RunDepth(reader_count + 1, duration_ms);
+    _bench_RunReplicated(reader_count + 1, duration_ms);
+    _bench_RunColumns(duration_ms);
+    return 0;
+}
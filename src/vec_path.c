@@ -4,6 +4,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdarg.h>
+#include <SDL3/SDL.h>
+
+static SDL_AtomicInt vec_path_next_id;
 
 char* _vec_Path_Combine(const char* path_1, const char* path_2) {
     DEBUG_ASSERT(path_1, "NULL pointer");
@@ -116,32 +119,15 @@ char* _vec_Path_Combine(const char* path_1, const char* path_2) {
     free(combined);
     return result;
 }
-int* vec_Path_ToIndices(const char* path, size_t* const out_indices_count) {
+// parses path into the caller's p_indices. returns the number of indices, or capacity + 1 when they do not fit.
+// path_length / 2 + 1 indices always fit
+size_t vec_Path_ToIndicesBuffer(const char* path, int* p_indices, size_t capacity) {
     DEBUG_ASSERT(path, "NULL pointer");
-    if (!path || !out_indices_count) {
-        return NULL; // Handle invalid inputs
-    }
-
-    size_t path_length = strlen(path);
-    if (path_length == 0) {
-        *out_indices_count = 0;
-        DEBUG_SCOPE(int* indices = alloc(NULL, sizeof(int)));
-        if (!indices) {
-            return NULL;
-        }
-        return indices; // Empty path returns empty array
-    }
-
-    // Initial capacity: estimate max number of tokens
-    size_t capacity = (path_length / 2) + 1;
-    DEBUG_SCOPE(int* indices = alloc(NULL, sizeof(int) * capacity));
-    if (!indices) {
-        return NULL; // Handle allocation failure
-    }
+    DEBUG_ASSERT(p_indices || capacity == 0, "NULL pointer");
     size_t count = 0;
 
     const char* p = path;
-    const char* end = path + path_length;
+    const char* end = path + strlen(path);
 
     while (p < end) {
         // Skip extra slashes
@@ -155,19 +141,13 @@ int* vec_Path_ToIndices(const char* path, size_t* const out_indices_count) {
         // Handle ".." component
         if (p + 1 < end && p[0] == '.' && p[1] == '.' &&
             (p + 2 == end || p[2] == '/')) {
-            if (count > 0 && indices[count - 1] != -1) {
+            if (count > 0 && p_indices[count - 1] != -1) {
                 count--; // Pop previous token
             } else {
                 if (count >= capacity) {
-                    capacity *= 2;
-                    DEBUG_SCOPE(int* new_indices = realloc(indices, sizeof(int) * capacity));
-                    if (!new_indices) {
-                        DEBUG_SCOPE(free(indices));
-                        return NULL;
-                    }
-                    indices = new_indices;
+                    return capacity + 1;
                 }
-                indices[count++] = -1;
+                p_indices[count++] = -1;
             }
             p += 2;
             if (p < end && *p == '/') {
@@ -195,24 +175,37 @@ int* vec_Path_ToIndices(const char* path, size_t* const out_indices_count) {
             p++;
         }
         if (count >= capacity) {
-            capacity *= 2;
-            DEBUG_SCOPE(int* new_indices = realloc(indices, sizeof(int) * capacity));
-            if (!new_indices) {
-                DEBUG_SCOPE(free(indices));
-                return NULL;
-            }
-            indices = new_indices;
+            return capacity + 1;
         }
-        indices[count++] = number;
+        p_indices[count++] = number;
+    }
+
+    return count;
+}
+int* vec_Path_ToIndices(const char* path, size_t* const out_indices_count) {
+    DEBUG_ASSERT(path, "NULL pointer");
+    if (!path || !out_indices_count) {
+        return NULL; // Handle invalid inputs
     }
 
+    // every index takes at least one digit and one slash
+    size_t capacity = (strlen(path) / 2) + 1;
+    DEBUG_SCOPE(int* indices = alloc(NULL, sizeof(int) * capacity));
+    if (!indices) {
+        return NULL; // Handle allocation failure
+    }
+    size_t count = vec_Path_ToIndicesBuffer(path, indices, capacity);
+    DEBUG_ASSERT(count <= capacity, "path has more indices than it has characters");
+
     // Shrink to fit
-    DEBUG_SCOPE(int* final_indices = realloc(indices, sizeof(int) * count));
-    if (!final_indices) {
-        DEBUG_SCOPE(free(indices));
-        return NULL;
+    if (count > 0) {
+        DEBUG_SCOPE(int* final_indices = realloc(indices, sizeof(int) * count));
+        if (!final_indices) {
+            DEBUG_SCOPE(free(indices));
+            return NULL;
+        }
+        indices = final_indices;
     }
-    indices = final_indices;
 
     *out_indices_count = count;
     return indices;
@@ -273,3 +266,18 @@ char* vec_Path_FromVaArgs(size_t n_args, ...) {
     free(p_indices);
     return ptr;
 }
+Vec_Path* vec_Path_Create(const char* path) {
+    DEBUG_ASSERT(path, "NULL pointer");
+    // every index takes at least one digit and one slash
+    size_t capacity = (strlen(path) / 2) + 1;
+    DEBUG_SCOPE(Vec_Path* p_path = alloc(NULL, sizeof(Vec_Path) + sizeof(int) * capacity));
+    size_t count = vec_Path_ToIndicesBuffer(path, p_path->p_indices, capacity);
+    DEBUG_ASSERT(count <= capacity, "path has more indices than it has characters");
+    p_path->id = (unsigned int)SDL_AddAtomicInt(&vec_path_next_id, 1) + 1;
+    p_path->indices_count = (unsigned int)count;
+    return p_path;
+}
+void vec_Path_Destroy(Vec_Path* p_path) {
+    DEBUG_ASSERT(p_path, "NULL pointer");
+    DEBUG_SCOPE(free(p_path));
+}
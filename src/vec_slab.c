@@ -0,0 +1,117 @@
+#include "vec_slab.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+
+#define VEC_SLAB_CLASSES_COUNT 7
+
+_Static_assert(VEC_SLAB_MIN_SIZE << (VEC_SLAB_CLASSES_COUNT - 1) == VEC_SLAB_MAX_SIZE, "every power of two from VEC_SLAB_MIN_SIZE to VEC_SLAB_MAX_SIZE needs a class");
+
+// free blocks are linked through their first bytes
+typedef struct Vec_SlabBlock Vec_SlabBlock;
+struct Vec_SlabBlock {
+    Vec_SlabBlock* p_next;
+};
+
+typedef struct Vec_SlabPool {
+    SDL_SpinLock    lock;
+    Vec_SlabBlock*  p_free;
+} Vec_SlabPool;
+
+typedef struct Vec_SlabCache {
+    unsigned int    p_counts[VEC_SLAB_CLASSES_COUNT];
+    void*           p_blocks[VEC_SLAB_CLASSES_COUNT][VEC_SLAB_CACHE_COUNT];
+} Vec_SlabCache;
+
+static Vec_SlabPool vec_slab_pools[VEC_SLAB_CLASSES_COUNT];
+static SDL_TLSID vec_slab_cache_id;
+
+static unsigned int _vec_Slab_GetClass(size_t size) {
+    unsigned int class_index = 0;
+    while (((size_t)VEC_SLAB_MIN_SIZE << class_index) < size) {
+        class_index++;
+    }
+    return class_index;
+}
+// takes up to count blocks of the class from its pool, carving a new slab when the pool is empty
+static unsigned int _vec_Slab_Take(unsigned int class_index, void** p_blocks, unsigned int count) {
+    Vec_SlabPool* p_pool = &vec_slab_pools[class_index];
+    size_t block_size = (size_t)VEC_SLAB_MIN_SIZE << class_index;
+    SDL_LockSpinlock(&p_pool->lock);
+    if (!p_pool->p_free) {
+        DEBUG_SCOPE(unsigned char* p_slab = alloc_Aligned(NULL, 0, VEC_SLAB_SIZE, VEC_SLAB_MIN_SIZE));
+        for (size_t offset = VEC_SLAB_SIZE; offset >= block_size; offset -= block_size) {
+            Vec_SlabBlock* p_block = (Vec_SlabBlock*)(p_slab + offset - block_size);
+            p_block->p_next = p_pool->p_free;
+            p_pool->p_free = p_block;
+        }
+    }
+    unsigned int taken = 0;
+    while (taken < count && p_pool->p_free) {
+        p_blocks[taken++] = p_pool->p_free;
+        p_pool->p_free = p_pool->p_free->p_next;
+    }
+    SDL_UnlockSpinlock(&p_pool->lock);
+    return taken;
+}
+static void _vec_Slab_Give(unsigned int class_index, void** p_blocks, unsigned int count) {
+    Vec_SlabPool* p_pool = &vec_slab_pools[class_index];
+    SDL_LockSpinlock(&p_pool->lock);
+    for (unsigned int i = 0; i < count; ++i) {
+        Vec_SlabBlock* p_block = p_blocks[i];
+        p_block->p_next = p_pool->p_free;
+        p_pool->p_free = p_block;
+    }
+    SDL_UnlockSpinlock(&p_pool->lock);
+}
+// blocks cached by a thread that exits go back to the pools
+static void _vec_Slab_DestroyCache(void* p_cache_void) {
+    Vec_SlabCache* p_cache = p_cache_void;
+    for (unsigned int i = 0; i < VEC_SLAB_CLASSES_COUNT; ++i) {
+        _vec_Slab_Give(i, p_cache->p_blocks[i], p_cache->p_counts[i]);
+    }
+    DEBUG_SCOPE(free(p_cache));
+}
+static Vec_SlabCache* _vec_Slab_GetCache() {
+    Vec_SlabCache* p_cache = SDL_GetTLS(&vec_slab_cache_id);
+    if (!p_cache) {
+        DEBUG_SCOPE(p_cache = alloc(NULL, sizeof(Vec_SlabCache)));
+        memset(p_cache->p_counts, 0, sizeof(p_cache->p_counts));
+        SDL_SetTLS(&vec_slab_cache_id, p_cache, _vec_Slab_DestroyCache);
+    }
+    return p_cache;
+}
+
+size_t vec_Slab_GetClassSize(size_t size) {
+    if (size == 0 || size > VEC_SLAB_MAX_SIZE) {
+        return 0;
+    }
+    return (size_t)VEC_SLAB_MIN_SIZE << _vec_Slab_GetClass(size);
+}
+void* vec_Slab_Alloc(size_t size) {
+    DEBUG_ASSERT(size > 0 && size <= VEC_SLAB_MAX_SIZE, "size(%zu) does not fit a slab", size);
+    unsigned int class_index = _vec_Slab_GetClass(size);
+    Vec_SlabCache* p_cache = _vec_Slab_GetCache();
+    unsigned int* p_count = &p_cache->p_counts[class_index];
+    if (*p_count == 0) {
+        *p_count = _vec_Slab_Take(class_index, p_cache->p_blocks[class_index], VEC_SLAB_CACHE_COUNT / 2);
+    }
+    return p_cache->p_blocks[class_index][--*p_count];
+}
+void vec_Slab_Free(void* ptr, size_t size) {
+    DEBUG_ASSERT(size > 0 && size <= VEC_SLAB_MAX_SIZE, "size(%zu) does not fit a slab", size);
+    if (!ptr) {
+        return;
+    }
+    unsigned int class_index = _vec_Slab_GetClass(size);
+    Vec_SlabCache* p_cache = _vec_Slab_GetCache();
+    unsigned int* p_count = &p_cache->p_counts[class_index];
+    if (*p_count == VEC_SLAB_CACHE_COUNT) {
+        // the older half goes back so the blocks freed last are the next ones handed out
+        _vec_Slab_Give(class_index, p_cache->p_blocks[class_index], VEC_SLAB_CACHE_COUNT / 2);
+        memmove(p_cache->p_blocks[class_index], p_cache->p_blocks[class_index] + VEC_SLAB_CACHE_COUNT / 2, VEC_SLAB_CACHE_COUNT / 2 * sizeof(void*));
+        *p_count = VEC_SLAB_CACHE_COUNT / 2;
+    }
+    p_cache->p_blocks[class_index][(*p_count)++] = ptr;
+}
@@ -0,0 +1,137 @@
+#include "vec_small.h"
+#include "vec_slab.h"
+#include "debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+Type vec_small_type = 0;
+
+_Static_assert(sizeof(Vec_Small) == 64, "Vec_Small should be exactly one cache line");
+
+__attribute__((constructor(104)))
+void _vec_Small_Constructor() {
+    vec_small_type = type_Create_Safe("Vec_Small", sizeof(Vec_Small), vec_Small_Destroy);
+}
+
+static bool _vec_Small_IsInline(Vec_Small* p_small, size_t element_size) {
+    return (size_t)p_small->capacity * element_size <= VEC_SMALL_INLINE_SIZE;
+}
+static unsigned char* _vec_Small_GetData(Vec_Small* p_small, size_t element_size) {
+    return _vec_Small_IsInline(p_small, element_size) ? p_small->p_inline : p_small->p_heap;
+}
+// spilled buffers are small, so without an allocator of the tree most of them come from the slabs
+static void* _vec_Small_Alloc(Vec_Small* p_small, size_t size) {
+    if (p_small->p_allocator) {
+        DEBUG_SCOPE(void* ptr = allocator_Alloc(p_small->p_allocator, size, sizeof(void*)));
+        return ptr;
+    }
+    if (vec_Slab_GetClassSize(size)) {
+        return vec_Slab_Alloc(size);
+    }
+    DEBUG_SCOPE(void* ptr = alloc(NULL, size));
+    return ptr;
+}
+static void _vec_Small_Free(Vec_Small* p_small, void* ptr, size_t size) {
+    if (p_small->p_allocator) {
+        DEBUG_SCOPE(allocator_Free(p_small->p_allocator, ptr, size));
+        return;
+    }
+    if (vec_Slab_GetClassSize(size)) {
+        vec_Slab_Free(ptr, size);
+        return;
+    }
+    DEBUG_SCOPE(free(ptr));
+}
+static void _vec_Small_Reserve(Vec_Small* p_small, unsigned int count, size_t element_size) {
+    if (count <= p_small->capacity) {
+        return;
+    }
+    unsigned int capacity = p_small->capacity ? p_small->capacity : 1;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    if ((size_t)capacity * element_size <= VEC_SMALL_INLINE_SIZE) {
+        p_small->capacity = capacity;
+        return;
+    }
+    unsigned char* p_data = _vec_Small_Alloc(p_small, (size_t)capacity * element_size);
+    memcpy(p_data, _vec_Small_GetData(p_small, element_size), (size_t)p_small->count * element_size);
+    if (!_vec_Small_IsInline(p_small, element_size)) {
+        _vec_Small_Free(p_small, p_small->p_heap, (size_t)p_small->capacity * element_size);
+    }
+    p_small->p_heap = p_data;
+    p_small->capacity = capacity;
+}
+
+void vec_Small_Initialize(Vec_Small* p_small, Vec* p_vec, Type type) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    DEBUG_ASSERT(type_IsValid_Safe(type), "type is invalid");
+    memset(p_small, 0, sizeof(Vec_Small));
+    p_small->type = type;
+    DEBUG_SCOPE(p_small->p_allocator = vec_GetAllocator(p_vec));
+    // as many elements as fit inline
+    DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(type));
+    p_small->capacity = element_size ? VEC_SMALL_INLINE_SIZE / element_size : 0;
+}
+void vec_Small_Destroy(void* p_small) {
+    Vec_Small* p_small_cast = (Vec_Small*)p_small;
+    DEBUG_ASSERT(p_small_cast, "NULL pointer");
+    if (p_small_cast->type == null_type) {
+        // never initialized
+        return;
+    }
+    DEBUG_SCOPE(Type_Info type_info = type_GetTypeInfo_Safe(p_small_cast->type));
+    unsigned char* p_data = _vec_Small_GetData(p_small_cast, type_info.size);
+    for (unsigned int i = 0; type_info.destructor && i < p_small_cast->count; ++i) {
+        type_info.destructor(p_data + (size_t)i * type_info.size);
+    }
+    if (!_vec_Small_IsInline(p_small_cast, type_info.size)) {
+        _vec_Small_Free(p_small_cast, p_small_cast->p_heap, (size_t)p_small_cast->capacity * type_info.size);
+    }
+    memset(p_small_cast, 0, sizeof(Vec_Small));
+}
+unsigned int vec_Small_GetCount_UnsafeRead(Vec_Small* p_small) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    return p_small->count;
+}
+unsigned char* vec_Small_GetElement_UnsafeRead(Vec_Small* p_small, unsigned int index, Type type) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    ASSERT(p_small->type == type, "wrong type");
+    DEBUG_ASSERT(index < p_small->count, "index(%u) is out of bounds(%u)", index, p_small->count);
+    DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(type));
+    return _vec_Small_GetData(p_small, element_size) + (size_t)index * element_size;
+}
+void vec_Small_SetCount_UnsafeWrite(Vec_Small* p_small, unsigned int count) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    DEBUG_ASSERT(p_small->type != null_type, "Vec_Small is not initialized");
+    DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_small->type));
+    if (count > p_small->count) {
+        _vec_Small_Reserve(p_small, count, element_size);
+        memset(_vec_Small_GetData(p_small, element_size) + (size_t)p_small->count * element_size, 0, (size_t)(count - p_small->count) * element_size);
+    }
+    p_small->count = count;
+}
+unsigned int vec_Small_Append_UnsafeWrite(Vec_Small* p_small, const void* p_element) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    DEBUG_ASSERT(p_small->type != null_type, "Vec_Small is not initialized");
+    DEBUG_SCOPE(size_t element_size = type_GetSize_Safe(p_small->type));
+    _vec_Small_Reserve(p_small, p_small->count + 1, element_size);
+    unsigned char* p_dst = _vec_Small_GetData(p_small, element_size) + (size_t)p_small->count * element_size;
+    if (p_element) {
+        memcpy(p_dst, p_element, element_size);
+    } else {
+        memset(p_dst, 0, element_size);
+    }
+    return p_small->count++;
+}
+void vec_Small_Remove_UnsafeWrite(Vec_Small* p_small, unsigned int index) {
+    DEBUG_ASSERT(p_small, "NULL pointer");
+    DEBUG_ASSERT(index < p_small->count, "index(%u) is out of bounds(%u)", index, p_small->count);
+    DEBUG_SCOPE(Type_Info type_info = type_GetTypeInfo_Safe(p_small->type));
+    unsigned char* p_element = _vec_Small_GetData(p_small, type_info.size) + (size_t)index * type_info.size;
+    if (type_info.destructor) {
+        type_info.destructor(p_element);
+    }
+    memmove(p_element, p_element + type_info.size, (size_t)(p_small->count - index - 1) * type_info.size);
+    p_small->count--;
+}